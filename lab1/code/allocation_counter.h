@@ -0,0 +1,14 @@
+// allocation_counter.h : count the calls to the global operator new
+// Linking allocation_counter.cpp replaces the global operator new and operator delete
+// Used by the tests and by the benchmark
+
+#pragma once
+
+#include <cstddef>
+
+namespace TND004 {
+
+    // Return number of calls to operator new since the start of the program (all threads)
+    std::size_t allocation_count();
+
+}  // namespace TND004
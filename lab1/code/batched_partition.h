@@ -0,0 +1,91 @@
+// batched_partition.h : stable partition of many short sequences in one call
+// The sequences are stored one after the other in a flat array of values, and an array of
+// offsets gives where every sequence (segment) starts, as in the CSR sparse matrix format:
+// segment s is values[offsets[s] .. offsets[s+1])
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "stable_partition.h"
+#include "task_pool.h"
+
+namespace TND004 {
+
+    /** Batched stable partition
+     *
+     * Stable-partition every segment of values by p
+     * All segments are partitioned in one pass over the values with the iterative algorithm,
+     * reusing the thread-local scratch arena, and with the vectorized kernels for
+     * int and float values with a predicate recognised by simd_partition.h
+     * \param offsets non-decreasing, offsets.size() = number of segments + 1
+     * Return the split point of every segment: the index in values of the first item
+     * not satisfying p, offsets[s+1] if all items of segment s satisfy p
+     */
+    template <typename T, typename Pred>
+    std::vector<std::size_t> stable_partition_batched(std::vector<T>& values, const std::vector<std::size_t>& offsets,
+                                                      Pred p) {
+        if (offsets.size() < 2) {
+            return {};
+        }
+        assert(offsets.back() <= values.size());
+
+        std::vector<std::size_t> split(offsets.size() - 1);
+        std::vector<T>& scratch = scratch_arena<T>();
+
+        for (std::size_t s = 0; s + 1 < offsets.size(); ++s) {
+            assert(offsets[s] <= offsets[s + 1]);
+            const auto first = values.begin() + static_cast<std::ptrdiff_t>(offsets[s]);
+            const auto last = values.begin() + static_cast<std::ptrdiff_t>(offsets[s + 1]);
+            split[s] = static_cast<std::size_t>(TND004::stable_partition_iterative(first, last, p, scratch) -
+                                                values.begin());
+        }
+        return split;
+    }
+
+    /** Parallel batched stable partition
+     *
+     * Same as stable_partition_batched, but the segments are grouped in tasks of about grain_size items
+     * which are executed by the pool, every worker reusing its own scratch arena
+     * Segments are never split between tasks
+     */
+    template <typename T, typename Pred>
+    std::vector<std::size_t> parallel_stable_partition_batched(std::vector<T>& values,
+                                                               const std::vector<std::size_t>& offsets, Pred p,
+                                                               TaskPool& pool,
+                                                               std::size_t grain_size = std::size_t{1} << 14) {
+        if (offsets.size() < 2) {
+            return {};
+        }
+        assert(offsets.back() <= values.size());
+
+        const std::size_t segments = offsets.size() - 1;
+
+        // task t partitions the segments [groups[t], groups[t+1])
+        std::vector<std::size_t> groups{0};
+        for (std::size_t s = 1; s < segments; ++s) {
+            if (offsets[s] - offsets[groups.back()] >= grain_size) {
+                groups.push_back(s);
+            }
+        }
+        groups.push_back(segments);
+
+        std::vector<std::size_t> split(segments);
+
+        parallel_for(pool, 0, groups.size() - 1, [&](std::size_t t) {
+            std::vector<T>& scratch = scratch_arena<T>();
+
+            for (std::size_t s = groups[t]; s < groups[t + 1]; ++s) {
+                assert(offsets[s] <= offsets[s + 1]);
+                const auto first = values.begin() + static_cast<std::ptrdiff_t>(offsets[s]);
+                const auto last = values.begin() + static_cast<std::ptrdiff_t>(offsets[s + 1]);
+                split[s] = static_cast<std::size_t>(TND004::stable_partition_iterative(first, last, p, scratch) -
+                                                    values.begin());
+            }
+        });
+        return split;
+    }
+
+}  // namespace TND004
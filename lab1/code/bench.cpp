@@ -0,0 +1,328 @@
+// bench.cpp : benchmark of the stable partition algorithms
+// Sweep the input size, the selectivity of the predicate (fraction of items satisfying it)
+// and the data pattern, and write one CSV line per run:
+//   algorithm,pattern,selectivity,size,ns_per_element,bytes_moved,allocations,peak_rss_kb
+// Usage: Lab1Bench [max_size] [output.csv]
+//   max_size: largest input size, sizes are 10, 100, ..., max_size (default 10^7, at most 10^9)
+//   output.csv: CSV file (default: standard output)
+// Build with -DCMAKE_BUILD_TYPE=Release, otherwise the timings are meaningless
+// peak_rss_kb is the peak resident set size of the process during the runs of the line: the peak is reset
+// before every line (Linux only, /proc/self/clear_refs), it is 0 where it cannot be reset
+// With -DTND004_PARTITION_STATS=ON, the counters of the last timed run (partition_stats.h) are also written
+// to the standard error, one JSON object per line; only the calling thread's work is counted
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "stable_partition.h"
+#include "parallel_partition.h"
+#include "multiway_partition.h"
+#include "allocation_counter.h"
+#include "partition_stats.h"
+
+/****************************************
+ * Declarations                          *
+ *****************************************/
+
+namespace {
+
+    // Item that counts its copies and moves, used to measure the number of bytes moved
+    struct Counted {
+        static std::atomic<std::size_t> moves;
+
+        int value{0};
+
+        Counted() = default;
+        explicit Counted(int v) : value{v} {
+        }
+
+        Counted(const Counted& c) : value{c.value} {
+            moves.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        Counted& operator=(const Counted& c) {
+            value = c.value;
+            moves.fetch_add(1, std::memory_order_relaxed);
+            return *this;
+        }
+    };
+
+    std::atomic<std::size_t> Counted::moves{0};
+
+    enum class Pattern { sorted, random, alternating };
+
+    const char* name(Pattern p);
+
+    /** Create the input sequence
+     *
+     * The items satisfying the predicate are the values < pivot, there are selectivity * n of them
+     * sorted: ascending values, i.e. already partitioned
+     * random: the items satisfying the predicate are at random positions
+     * alternating: the items satisfying the predicate are evenly spread over the sequence
+     */
+    std::vector<int> make_input(std::size_t n, double selectivity, Pattern pattern, int& pivot);
+
+    // Result of one benchmark run
+    struct Measure {
+        double ns_per_element;
+        std::size_t bytes_moved;
+        std::size_t allocations;
+        long peak_rss_kb;
+        std::string stats_json;  // counters of the last timed run, empty without TND004_PARTITION_STATS
+    };
+
+    /** Class to represent an algorithm under test
+     *
+     * run_int partitions a vector of ints (timed)
+     * run_counted partitions a vector of Counted, to count the items moved (not timed)
+     */
+    struct Algorithm {
+        std::string name;
+        std::function<void(std::vector<int>&, int)> run_int;
+        std::function<void(std::vector<Counted>&, int)> run_counted;
+    };
+
+    std::vector<Algorithm> algorithms();
+
+    Measure measure(const Algorithm& a, const std::vector<int>& input, int pivot);
+
+    // Reset the peak resident set size of the process to the current one, return false if not supported
+    bool reset_peak_rss();
+
+    // Return the peak resident set size since reset_peak_rss, in KiB
+    long peak_rss_kb();
+
+}  // namespace
+
+/****************************************
+ * Main                                  *
+ *****************************************/
+
+int main(int argc, char* argv[]) {
+    std::size_t max_size = 10'000'000;
+    if (argc > 1) {
+        max_size = std::min<std::size_t>(std::strtoull(argv[1], nullptr, 10), 1'000'000'000);
+    }
+
+    std::ofstream file;
+    if (argc > 2) {
+        file.open(argv[2]);
+        if (!file) {
+            std::cerr << "Could not open " << argv[2] << "!!\n";
+            return 1;
+        }
+    }
+    std::ostream& os = (argc > 2) ? file : std::cout;
+
+    os << "algorithm,pattern,selectivity,size,ns_per_element,bytes_moved,allocations,peak_rss_kb\n";
+
+    const std::vector<Algorithm> algos = algorithms();
+
+    for (std::size_t n = 10; n <= max_size; n *= 10) {
+        for (double selectivity : {0.0, 0.25, 0.5, 0.75, 1.0}) {
+            for (Pattern pattern : {Pattern::sorted, Pattern::random, Pattern::alternating}) {
+                int pivot;
+                const std::vector<int> input = make_input(n, selectivity, pattern, pivot);
+
+                for (const Algorithm& a : algos) {
+                    const Measure m = measure(a, input, pivot);
+
+                    os << a.name << ',' << name(pattern) << ',' << selectivity << ',' << n << ','
+                       << m.ns_per_element << ',' << m.bytes_moved << ',' << m.allocations << ','
+                       << m.peak_rss_kb << '\n';
+
+#if TND004_PARTITION_STATS
+                    std::cerr << "{\"algorithm\":\"" << a.name << "\",\"pattern\":\"" << name(pattern)
+                              << "\",\"selectivity\":" << selectivity << ",\"size\":" << n
+                              << ",\"stats\":" << m.stats_json << "}\n";
+#endif
+                }
+            }
+        }
+        os.flush();
+    }
+}
+
+/****************************************
+ * Functions definitions                 *
+ *****************************************/
+
+namespace {
+
+    const char* name(Pattern p) {
+        switch (p) {
+            case Pattern::sorted: return "sorted";
+            case Pattern::random: return "random";
+            default: return "alternating";
+        }
+    }
+
+    std::vector<int> make_input(std::size_t n, double selectivity, Pattern pattern, int& pivot) {
+        const auto even = static_cast<std::size_t>(selectivity * static_cast<double>(n));
+        pivot = static_cast<int>(even);
+
+        // values 0 .. n-1, the first even values satisfy the predicate
+        std::vector<int> V(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            V[i] = static_cast<int>(i);
+        }
+
+        if (pattern == Pattern::random) {
+            std::shuffle(std::begin(V), std::end(V), std::mt19937{static_cast<unsigned>(n)});
+        } else if (pattern == Pattern::alternating) {
+            // item i satisfies the predicate if the count (i+1) * even / n increases at i
+            std::size_t next_even = 0;
+            std::size_t next_uneven = even;
+            for (std::size_t i = 0; i < n; ++i) {
+                const bool is_even = (i + 1) * even / n > i * even / n;
+                V[i] = static_cast<int>(is_even ? next_even++ : next_uneven++);
+            }
+        }
+        return V;
+    }
+
+    // The algorithms are applied to vectors of ints and of Counted
+    template <typename T>
+    auto less_than_pivot(int pivot) {
+        if constexpr (std::is_same_v<T, int>) {
+            return [pivot](int x) { return x < pivot; };
+        } else {
+            return [pivot](const Counted& x) { return x.value < pivot; };
+        }
+    }
+
+    template <typename F>
+    Algorithm make_algorithm(std::string name, F f) {
+        return Algorithm{std::move(name), [f](std::vector<int>& V, int pivot) { f(V, less_than_pivot<int>(pivot)); },
+                         [f](std::vector<Counted>& V, int pivot) { f(V, less_than_pivot<Counted>(pivot)); }};
+    }
+
+    std::vector<Algorithm> algorithms() {
+        std::vector<Algorithm> result;
+
+        result.push_back(make_algorithm("iterative", [](auto& V, auto p) {
+            TND004::stable_partition_iterative(std::begin(V), std::end(V), p);
+        }));
+
+        result.push_back(make_algorithm("divide_and_conquer", [](auto& V, auto p) {
+            TND004::stable_partition(std::begin(V), std::end(V), p);
+        }));
+
+        result.push_back(make_algorithm("bottom_up", [](auto& V, auto p) {
+            TND004::stable_partition_bottom_up(std::begin(V), std::end(V), p);
+        }));
+
+        result.push_back(make_algorithm("std_stable_partition", [](auto& V, auto p) {
+            std::stable_partition(std::begin(V), std::end(V), p);
+        }));
+
+        result.push_back(make_algorithm("adaptive_1MiB", [](auto& V, auto p) {
+            TND004::stable_partition_adaptive(std::begin(V), std::end(V), p, std::size_t{1} << 20);
+        }));
+
+        result.push_back(make_algorithm("parallel_divide_and_conquer", [](auto& V, auto p) {
+            TND004::parallel_stable_partition(std::begin(V), std::end(V), p, TND004::default_pool());
+        }));
+
+        result.push_back(make_algorithm("scan", [](auto& V, auto p) {
+            TND004::scan_stable_partition(std::begin(V), std::end(V), p, TND004::default_pool());
+        }));
+
+        result.push_back(make_algorithm("multiway_k2", [](auto& V, auto p) {
+            TND004::stable_partition_multiway(std::begin(V), std::end(V), [p](const auto& x) { return p(x) ? 0 : 1; }, 2);
+        }));
+
+        // vectorized kernel: the predicate must be TND004::less_than<int>, so there is no Counted version
+        // and the moves are the ones of the scalar iterative algorithm
+        result.push_back(Algorithm{"simd_iterative",
+                                   [](std::vector<int>& V, int pivot) {
+                                       TND004::stable_partition_iterative(std::begin(V), std::end(V),
+                                                                          TND004::less_than<int>{pivot});
+                                   },
+                                   [](std::vector<Counted>& V, int pivot) {
+                                       TND004::stable_partition_iterative(std::begin(V), std::end(V),
+                                                                          less_than_pivot<Counted>(pivot));
+                                   }});
+
+        return result;
+    }
+
+    Measure measure(const Algorithm& a, const std::vector<int>& input, int pivot) {
+        using clock = std::chrono::steady_clock;
+
+        const std::size_t n = input.size();
+
+        // repeat small inputs, such that every measure partitions about 10^7 items; keep the best time
+        const std::size_t repeat = std::max<std::size_t>(1, std::min<std::size_t>(10'000'000 / n, 1000));
+
+        // the previous lines do not count in the peak resident set size
+        const bool peak_reset = reset_peak_rss();
+
+        // warm-up run, such that the scratch arenas have their final size
+        std::vector<int> V{input};
+        a.run_int(V, pivot);
+
+        double best = 1e300;
+        std::size_t allocs = 0;
+
+        for (std::size_t r = 0; r < repeat; ++r) {
+            V = input;
+            TND004_STATS(TND004::partition_stats().reset());
+
+            const std::size_t allocs_before = TND004::allocation_count();
+            const auto start = clock::now();
+            a.run_int(V, pivot);
+            const auto stop = clock::now();
+            allocs = TND004::allocation_count() - allocs_before;
+
+            best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+
+        std::string stats_json;
+        TND004_STATS(stats_json = TND004::partition_stats().to_json());
+
+        std::vector<Counted> C;
+        C.reserve(n);
+        for (int x : input) {
+            C.emplace_back(x);
+        }
+        std::vector<Counted> C0{C};
+        a.run_counted(C0, pivot);  // warm-up run
+
+        Counted::moves = 0;
+        a.run_counted(C, pivot);
+
+        return Measure{best / static_cast<double>(n), Counted::moves.load() * sizeof(int), allocs,
+                       peak_reset ? peak_rss_kb() : 0, stats_json};
+    }
+
+    bool reset_peak_rss() {
+        // writing 5 to clear_refs resets the VmHWM of /proc/self/status (since Linux 4.0)
+        std::ofstream clear_refs{"/proc/self/clear_refs"};
+        return static_cast<bool>(clear_refs << "5" << std::flush);
+    }
+
+    long peak_rss_kb() {
+        std::ifstream status{"/proc/self/status"};
+        for (std::string line; std::getline(status, line);) {
+            if (line.rfind("VmHWM:", 0) == 0) {
+                std::istringstream is{line.substr(6)};
+                long kb = 0;
+                is >> kb;
+                return kb;
+            }
+        }
+        return 0;
+    }
+
+}  // namespace
@@ -0,0 +1,199 @@
+#include "external_partition.h"
+#include "int_io.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+namespace TND004 {
+
+    namespace {
+        // Minimum chunk size, such that a chunk always holds at least one complete int
+        constexpr std::size_t min_chunk_bytes = 64;
+
+        bool is_space(char c) {
+            return std::isspace(static_cast<unsigned char>(c)) != 0;
+        }
+    }  // namespace
+
+    /* **************************************** *
+     * IntFileReader                            *
+     * **************************************** */
+
+    IntFileReader::IntFileReader(const std::string& path, std::size_t chunk_bytes)
+        : file_{path, std::ios::binary}, chunk_bytes_{std::max(chunk_bytes, min_chunk_bytes)} {
+        if (!file_) {
+            throw std::runtime_error{"could not open " + path};
+        }
+
+        reading_ = std::async(std::launch::async, [this] { read_chunk(ahead_); });
+    }
+
+    IntFileReader::~IntFileReader() {
+        if (reading_.valid()) {
+            reading_.wait();
+        }
+    }
+
+    bool IntFileReader::next(std::vector<int>& values) {
+        // a chunk holding only whitespace has no ints: go on with the next one
+        while (reading_.valid()) {
+            reading_.get();  // rethrows the exceptions of the background read
+            std::swap(values, ahead_);
+
+            if (!eof_) {
+                reading_ = std::async(std::launch::async, [this] { read_chunk(ahead_); });
+            }
+
+            if (!values.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void IntFileReader::read_chunk(std::vector<int>& values) {
+        values.clear();
+
+        bytes_.resize(carry_ + chunk_bytes_);
+        file_.read(bytes_.data() + carry_, static_cast<std::streamsize>(chunk_bytes_));
+        const std::size_t size = carry_ + static_cast<std::size_t>(file_.gcount());
+
+        if (file_.bad()) {
+            throw std::runtime_error{"error while reading the input file"};
+        }
+
+        const char* first = bytes_.data();
+        const char* last = first + size;
+
+        if (file_.eof()) {
+            eof_ = true;
+            parse_ints(first, last, values);
+            return;
+        }
+
+        // the last token may continue in the next chunk
+        const char* end = last;
+        while (end != first && !is_space(end[-1])) {
+            --end;
+        }
+        if (end == first) {
+            throw std::runtime_error{"token too long in input file"};
+        }
+
+        parse_ints(first, end, values);
+
+        carry_ = static_cast<std::size_t>(last - end);
+        std::copy(end, last, bytes_.data());
+    }
+
+    /* **************************************** *
+     * IntFileWriter                            *
+     * **************************************** */
+
+    IntFileWriter::IntFileWriter(const std::string& path, std::size_t chunk_bytes)
+        : file_{path, std::ios::binary | std::ios::trunc},
+          chunk_bytes_{std::max(chunk_bytes, min_chunk_bytes)},
+          buffer_(chunk_bytes_) {
+        if (!file_) {
+            throw std::runtime_error{"could not open " + path};
+        }
+        pending_.reserve(chunk_bytes_);
+    }
+
+    IntFileWriter::~IntFileWriter() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    void IntFileWriter::write(int value) {
+        constexpr std::size_t max_chars = 12;  // sign, 10 digits and '\n'
+
+        if (used_ + max_chars > buffer_.size()) {
+            submit();
+        }
+
+        char* first = buffer_.data() + used_;
+        char* last = std::to_chars(first, first + max_chars, value).ptr;
+        *last++ = '\n';
+        used_ += static_cast<std::size_t>(last - first);
+    }
+
+    void IntFileWriter::close() {
+        if (!file_.is_open()) {
+            return;
+        }
+
+        submit();
+        if (writing_.valid()) {
+            writing_.get();
+        }
+
+        file_.close();
+        if (!file_) {
+            throw std::runtime_error{"error while closing an output file"};
+        }
+    }
+
+    void IntFileWriter::submit() {
+        if (writing_.valid()) {
+            writing_.get();  // rethrows the exceptions of the background write
+        }
+        if (used_ == 0) {
+            return;
+        }
+
+        // swap the buffers: the filled one is written while the other one is filled
+        pending_.resize(buffer_.size());
+        std::swap(buffer_, pending_);
+        const std::size_t count = used_;
+        used_ = 0;
+
+        writing_ = std::async(std::launch::async, [this, count] {
+            file_.write(pending_.data(), static_cast<std::streamsize>(count));
+            if (!file_) {
+                throw std::runtime_error{"error while writing an output file"};
+            }
+        });
+    }
+
+    /* **************************************** *
+     * TemporaryFile                            *
+     * **************************************** */
+
+    TemporaryFile::TemporaryFile(std::string path) : path_{std::move(path)} {
+    }
+
+    TemporaryFile::~TemporaryFile() {
+        std::remove(path_.c_str());
+    }
+
+    /* **************************************** *
+     * Functions                                *
+     * **************************************** */
+
+    void append_file(const std::string& dest, const std::string& source, std::size_t chunk_bytes) {
+        std::ifstream in{source, std::ios::binary};
+        std::ofstream out{dest, std::ios::binary | std::ios::app};
+
+        if (!in || !out) {
+            throw std::runtime_error{"could not append " + source + " to " + dest};
+        }
+
+        std::vector<char> block(std::max(chunk_bytes, min_chunk_bytes));
+        while (in) {
+            in.read(block.data(), static_cast<std::streamsize>(block.size()));
+            out.write(block.data(), in.gcount());
+        }
+
+        if (in.bad() || !out.flush()) {
+            throw std::runtime_error{"could not append " + source + " to " + dest};
+        }
+    }
+
+}  // namespace TND004
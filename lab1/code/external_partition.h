@@ -0,0 +1,156 @@
+// external_partition.h : out-of-core stable partition of integer files larger than RAM
+// The input is streamed in chunks, items satisfying the predicate are written directly to the
+// output file and the other items are spilled to a temporary file, appended at the end
+// Reads and writes run in background threads (double buffering), such that
+// the memory use is a few chunks whatever the size of the input
+
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <future>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace TND004 {
+
+    // Default size of the chunks read and written, in bytes
+    constexpr std::size_t external_chunk_bytes = std::size_t{1} << 24;
+
+    /** Class to read whitespace-separated ints from a text file, one chunk at a time
+     *
+     * The next chunk is read and parsed in the background while the current one is processed
+     * Throw std::runtime_error if the file cannot be opened or contains an invalid token
+     */
+    class IntFileReader {
+    public:
+        IntFileReader(const std::string& path, std::size_t chunk_bytes = external_chunk_bytes);
+
+        // Destructor: wait for the background read
+        ~IntFileReader();
+
+        IntFileReader(const IntFileReader&) = delete;
+        IntFileReader& operator=(const IntFileReader&) = delete;
+
+        /** Replace the contents of values by the ints of the next chunk
+         *
+         * Return false if there are no more ints in the file
+         */
+        bool next(std::vector<int>& values);
+
+    private:
+        void read_chunk(std::vector<int>& values);  // executed in the background
+
+        std::ifstream file_;
+        std::size_t chunk_bytes_;
+        std::vector<char> bytes_;  // raw chunk, starting with the carried incomplete token
+        std::size_t carry_{0};     // length of the incomplete token at the end of the previous chunk
+        bool eof_{false};
+
+        std::vector<int> ahead_;  // chunk read in the background
+        std::future<void> reading_;
+    };
+
+    /** Class to write ints to a text file, one per line
+     *
+     * The ints are formatted into a chunk buffer which is written in the background
+     * while the next buffer is filled
+     * Throw std::runtime_error if the file cannot be opened or written
+     */
+    class IntFileWriter {
+    public:
+        IntFileWriter(const std::string& path, std::size_t chunk_bytes = external_chunk_bytes);
+
+        // Destructor: flush and close the file, errors are ignored (call close to detect them)
+        ~IntFileWriter();
+
+        IntFileWriter(const IntFileWriter&) = delete;
+        IntFileWriter& operator=(const IntFileWriter&) = delete;
+
+        void write(int value);
+
+        // Flush all buffered ints and close the file
+        void close();
+
+    private:
+        void submit();  // hand the filled buffer to the background writer
+
+        std::ofstream file_;
+        std::size_t chunk_bytes_;
+        std::vector<char> buffer_;   // buffer being filled
+        std::size_t used_{0};        // number of chars in buffer_
+        std::vector<char> pending_;  // buffer being written in the background
+        std::future<void> writing_;
+    };
+
+    /** Class to represent a temporary file, removed by the destructor
+     *
+     * Such that the file is also removed when an exception is thrown
+     * The file itself is created by the user of the path
+     */
+    class TemporaryFile {
+    public:
+        explicit TemporaryFile(std::string path);
+
+        // Destructor: remove the file, if it exists
+        ~TemporaryFile();
+
+        TemporaryFile(const TemporaryFile&) = delete;
+        TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+        const std::string& path() const {
+            return path_;
+        }
+
+    private:
+        std::string path_;
+    };
+
+    /** Append the contents of file source to file dest
+     *
+     * The file is copied in blocks of chunk_bytes
+     */
+    void append_file(const std::string& dest, const std::string& source,
+                     std::size_t chunk_bytes = external_chunk_bytes);
+
+    /** Out-of-core stable partition
+     *
+     * Stable-partition the whitespace-separated ints in file input and write them to file output,
+     * one per line, the items satisfying p first
+     * The items not satisfying p are spilled to the temporary file output + ".uneven.tmp",
+     * which is removed on return and when an exception is thrown
+     * \param chunk_bytes size of the chunks read and written (at least 64 bytes)
+     * Return the number of items satisfying p
+     */
+    template <typename Pred>
+    std::size_t external_stable_partition(const std::string& input, const std::string& output, Pred p,
+                                          std::size_t chunk_bytes = external_chunk_bytes) {
+        const TemporaryFile spill{output + ".uneven.tmp"};  // destroyed after uneven_out closed it
+        std::size_t even = 0;
+
+        IntFileReader reader{input, chunk_bytes};
+        IntFileWriter even_out{output, chunk_bytes};
+        IntFileWriter uneven_out{spill.path(), chunk_bytes};
+
+        std::vector<int> values;
+        while (reader.next(values)) {
+            for (int v : values) {
+                if (p(v)) {
+                    even_out.write(v);
+                    ++even;
+                } else {
+                    uneven_out.write(v);
+                }
+            }
+        }
+
+        even_out.close();
+        uneven_out.close();
+
+        append_file(output, spill.path(), chunk_bytes);
+
+        return even;
+    }
+
+}  // namespace TND004
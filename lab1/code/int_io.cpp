@@ -0,0 +1,274 @@
+#include "int_io.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TND004_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define TND004_HAS_MMAP 0
+#endif
+
+namespace TND004 {
+
+    namespace {
+
+        bool is_space(char c) {
+            return std::isspace(static_cast<unsigned char>(c)) != 0;
+        }
+
+        bool host_is_little_endian() {
+            const std::uint32_t one = 1;
+            unsigned char first_byte;
+            std::memcpy(&first_byte, &one, 1);
+            return first_byte == 1;
+        }
+
+        // Convert between the file byte order (little-endian) and the host byte order
+        void convert_byte_order(std::vector<int>& values) {
+            if (host_is_little_endian()) {
+                return;
+            }
+
+            for (int& v : values) {
+                auto u = static_cast<std::uint32_t>(v);
+                u = (u >> 24) | ((u >> 8) & 0xFF00u) | ((u << 8) & 0xFF0000u) | (u << 24);
+                v = static_cast<int>(u);
+            }
+        }
+
+        // Read a whole file into values, the size of the file must be a multiple of sizeof(int)
+        bool read_binary(const std::string& path, std::vector<int>& values) {
+            std::ifstream file{path, std::ios::binary | std::ios::ate};
+
+            if (!file) {
+                return false;
+            }
+
+            const auto bytes = static_cast<std::size_t>(file.tellg());
+            if (bytes % sizeof(int) != 0) {
+                return false;
+            }
+
+            values.resize(bytes / sizeof(int));
+            file.seekg(0);
+            file.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(bytes));
+
+            convert_byte_order(values);
+            return static_cast<bool>(file);
+        }
+
+    }  // namespace
+
+    void parse_ints(const char* first, const char* last, std::vector<int>& values) {
+        while (true) {
+            while (first != last && is_space(*first)) {
+                ++first;
+            }
+            if (first == last) {
+                return;
+            }
+
+            int v;
+            const auto [ptr, ec] = std::from_chars(first, last, v);
+            if (ec != std::errc{} || (ptr != last && !is_space(*ptr))) {
+                throw std::runtime_error{"invalid int: " + std::string(first, std::min(ptr + 1, last))};
+            }
+            values.push_back(v);
+            first = ptr;
+        }
+    }
+
+    bool load_ints(const std::string& path, std::vector<int>& values) {
+        values.clear();
+
+#if TND004_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+
+        const auto bytes = static_cast<std::size_t>(info.st_size);
+        if (bytes == 0) {
+            ::close(fd);
+            return true;
+        }
+
+        void* map = ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // the mapping stays valid
+
+        if (map == MAP_FAILED) {
+            return false;
+        }
+        ::madvise(map, bytes, MADV_SEQUENTIAL);
+
+        const char* text = static_cast<const char*>(map);
+        try {
+            parse_ints(text, text + bytes, values);
+        } catch (...) {
+            ::munmap(map, bytes);
+            throw;
+        }
+
+        ::munmap(map, bytes);
+        return true;
+#else
+        std::ifstream file{path, std::ios::binary};
+
+        if (!file) {
+            return false;
+        }
+
+        const std::string text{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        parse_ints(text.data(), text.data() + text.size(), values);
+        return true;
+#endif
+    }
+
+    bool load_ints_binary(const std::string& path, std::vector<int>& values) {
+        values.clear();
+        return read_binary(path, values);
+    }
+
+    bool save_ints_binary(const std::string& path, const std::vector<int>& values) {
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+
+        if (!file) {
+            return false;
+        }
+
+        if (host_is_little_endian()) {
+            file.write(reinterpret_cast<const char*>(values.data()),
+                       static_cast<std::streamsize>(values.size() * sizeof(int)));
+        } else {
+            std::vector<int> swapped{values};
+            convert_byte_order(swapped);
+            file.write(reinterpret_cast<const char*>(swapped.data()),
+                       static_cast<std::streamsize>(swapped.size() * sizeof(int)));
+        }
+
+        return static_cast<bool>(file.flush());
+    }
+
+    /* **************************************** *
+     * MappedIntFile                            *
+     * **************************************** */
+
+    MappedIntFile::MappedIntFile(const std::string& path) : path_{path} {
+#if TND004_HAS_MMAP
+        if (host_is_little_endian()) {
+            const int fd = ::open(path.c_str(), O_RDWR);
+            if (fd < 0) {
+                return;
+            }
+
+            struct stat info;
+            if (::fstat(fd, &info) != 0 || info.st_size % sizeof(int) != 0) {
+                ::close(fd);
+                return;
+            }
+
+            size_ = static_cast<std::size_t>(info.st_size) / sizeof(int);
+            if (size_ > 0) {
+                void* map = ::mmap(nullptr, size_ * sizeof(int), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (map == MAP_FAILED) {
+                    ::close(fd);
+                    size_ = 0;
+                    return;
+                }
+                data_ = static_cast<int*>(map);
+                mapped_ = true;
+            }
+
+            ::close(fd);  // the mapping stays valid
+            ok_ = true;
+            return;
+        }
+#endif
+        // no memory mapping: work on a copy
+        ok_ = read_binary(path, copy_);
+        copied_ = true;
+        data_ = copy_.data();
+        size_ = copy_.size();
+    }
+
+    MappedIntFile::~MappedIntFile() {
+        if (!ok_) {
+            return;
+        }
+
+        if (mapped_) {
+#if TND004_HAS_MMAP
+            ::munmap(data_, size_ * sizeof(int));
+#endif
+        } else if (copied_) {
+            convert_byte_order(copy_);
+            std::ofstream file{path_, std::ios::binary | std::ios::trunc};
+            file.write(reinterpret_cast<const char*>(copy_.data()),
+                       static_cast<std::streamsize>(copy_.size() * sizeof(int)));
+        }
+    }
+
+    IntWriter::IntWriter(std::ostream& os, int width, int per_line, std::string_view separator,
+                         std::size_t buffer_bytes)
+        : os_{os}
+        , width_{static_cast<std::size_t>(std::max(width, 0))}
+        , per_line_{per_line}
+        , separator_{separator} {
+        // room for at least one item: padding or 11 chars (sign and 10 digits), separator and newline
+        buffer_.resize(std::max(buffer_bytes, std::max<std::size_t>(width_, 11) + separator_.size() + 1));
+    }
+
+    IntWriter::~IntWriter() {
+        flush();
+    }
+
+    void IntWriter::write(int value) {
+        const std::size_t max_chars = std::max<std::size_t>(width_, 11) + separator_.size() + 1;
+
+        if (used_ + max_chars > buffer_.size()) {
+            flush();
+        }
+
+        char digits[11];
+        char* last = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        const auto length = static_cast<std::size_t>(last - digits);
+
+        char* out = buffer_.data() + used_;
+        if (length < width_) {
+            out = std::fill_n(out, width_ - length, ' ');
+        }
+        out = std::copy(digits, last, out);
+        out = std::copy(separator_.begin(), separator_.end(), out);
+
+        if (per_line_ > 0 && ++outputted_ == per_line_) {
+            *out++ = '\n';
+            outputted_ = 0;
+        }
+
+        used_ = static_cast<std::size_t>(out - buffer_.data());
+    }
+
+    void IntWriter::flush() {
+        if (used_ > 0) {
+            os_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+            used_ = 0;
+        }
+    }
+
+}  // namespace TND004
@@ -0,0 +1,133 @@
+// int_io.h : fast input of int sequences
+// Text files are memory-mapped and parsed with std::from_chars
+// Binary files store the ints as raw 32-bit little-endian values, without any header,
+// such that they can be memory-mapped and partitioned in place
+// Text output is formatted with std::to_chars into a buffer written with one call per buffer
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace TND004 {
+
+    /** Parse the whitespace-separated ints in [first, last) and append them to values
+     *
+     * Throw std::runtime_error if a token is not a valid int
+     */
+    void parse_ints(const char* first, const char* last, std::vector<int>& values);
+
+    /** Read all whitespace-separated ints of a text file
+     *
+     * Replace the contents of values by the ints in the file
+     * Return false if the file could not be opened
+     * Throw std::runtime_error if the file contains an invalid token
+     */
+    bool load_ints(const std::string& path, std::vector<int>& values);
+
+    /** Read all ints of a binary file
+     *
+     * Replace the contents of values by the ints in the file
+     * Return false if the file could not be opened, or if its size is not a multiple of 4 bytes
+     */
+    bool load_ints_binary(const std::string& path, std::vector<int>& values);
+
+    /** Write the ints in values to a binary file
+     *
+     * Return false if the file could not be written
+     */
+    bool save_ints_binary(const std::string& path, const std::vector<int>& values);
+
+    /** Class to represent a binary int file mapped in memory
+     *
+     * The ints can be read and modified in place, through begin() and end(),
+     * and the modifications are written back to the file
+     * Where memory mapping is not available, the file is loaded in memory and written back
+     * by the destructor
+     */
+    class MappedIntFile {
+    public:
+        // Map the file, test the object (operator bool) to know whether it succeeded
+        explicit MappedIntFile(const std::string& path);
+
+        // Destructor: unmap the file
+        ~MappedIntFile();
+
+        MappedIntFile(const MappedIntFile&) = delete;
+        MappedIntFile& operator=(const MappedIntFile&) = delete;
+
+        // Return true if the file is mapped
+        explicit operator bool() const {
+            return ok_;
+        }
+
+        int* begin() {
+            return data_;
+        }
+
+        int* end() {
+            return data_ + size_;
+        }
+
+        // Return number of ints in the file
+        std::size_t size() const {
+            return size_;
+        }
+
+    private:
+        int* data_{nullptr};
+        std::size_t size_{0};
+        bool ok_{false};
+        bool mapped_{false};  // data_ points to a memory mapping
+        bool copied_{false};  // data_ points to copy_
+
+        std::string path_;
+        std::vector<int> copy_;  // the ints, if the file could not be mapped
+    };
+
+    /** Class to write ints to a stream, in columns
+     *
+     * Same layout as Formatter in lab1.cpp: every int is right-aligned in a column of width chars
+     * (std::setw), followed by separator, and a newline is written after every per_line ints
+     * The ints are formatted with std::to_chars into a buffer of buffer_bytes, which is written
+     * to the stream with one call to write when it is full, by flush and by the destructor
+     * \param per_line number of columns per line, 0 for no line breaks
+     */
+    class IntWriter {
+    public:
+        IntWriter(std::ostream& os, int width, int per_line, std::string_view separator = {},
+                  std::size_t buffer_bytes = std::size_t{1} << 16);
+
+        // Destructor: flush the buffer
+        ~IntWriter();
+
+        IntWriter(const IntWriter&) = delete;
+        IntWriter& operator=(const IntWriter&) = delete;
+
+        void write(int value);
+
+        template <typename InputIt>
+        void write(InputIt first, InputIt last) {
+            for (; first != last; ++first) {
+                write(*first);
+            }
+        }
+
+        // Write the buffered chars to the stream
+        void flush();
+
+    private:
+        std::ostream& os_;
+        const std::size_t width_;
+        const int per_line_;
+        const std::string separator_;
+        int outputted_{0};  // number of ints on the current line
+
+        std::vector<char> buffer_;
+        std::size_t used_{0};  // number of chars in buffer_
+    };
+
+}  // namespace TND004
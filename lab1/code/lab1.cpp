@@ -3,12 +3,28 @@
 
 #include <iostream>
 #include <vector>
+#include <list>
 #include <algorithm>
 #include <iterator>
 #include <fstream>
 #include <iomanip>
 #include <functional>
 #include <cassert>
+#include <random>
+#include <string>
+#include <sstream>
+#include <limits>
+#include <stdexcept>
+
+#include "stable_partition.h"
+#include "parallel_partition.h"
+#include "multiway_partition.h"
+#include "partitioned_sequence.h"
+#include "batched_partition.h"
+#include "external_partition.h"
+#include "int_io.h"
+#include "allocation_counter.h"
+#include "partition_stats.h"
 
 /****************************************
  * Declarations                          *
@@ -37,6 +53,8 @@ private:
 
 /* *************************************** */
 
+// The generic versions of both algorithms (any iterator, any callable) are in stable_partition.h
+// The functions below are kept as thin wrappers for std::vector<int> and std::function
 namespace TND004 {
     // Iterative algorithm
     void stable_partition_iterative(std::vector<int>& V, std::function<bool(int)> p);
@@ -49,10 +67,14 @@ namespace TND004 {
 
     // Divide-and-conquer algorithm
     void stable_partition(std::vector<int>& V, std::function<bool(int)> p) {
+            if (V.empty()) {
+                std::cout << "Vector is empty" << std::endl;
+                return;
+            }
             TND004::stable_partition(std::begin(V), std::end(V), p);  // call auxiliary function
+    }
+}  // namespace TND004
 
-    }  // namespace TND004
-}
 void execute(std::vector<int>& V, const std::vector<int>& res);
 
 bool even(int i);
@@ -71,7 +93,7 @@ int main() {
         std::vector<int> seq{1, 2};
 
         std::cout << "Sequence: ";
-        std::copy(std::begin(seq), std::end(seq), std::ostream_iterator<int>{std::cout, " "});
+        TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(seq), std::end(seq));
 
 
         execute(seq, std::vector<int>{2, 1});
@@ -91,7 +113,7 @@ int main() {
         std::vector<int> seq{2};
 
         std::cout << "Sequence: ";
-        std::copy(std::begin(seq), std::end(seq), std::ostream_iterator<int>{std::cout, " "});
+        TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(seq), std::end(seq));
 
         execute(seq, std::vector<int>{2});
     }
@@ -105,7 +127,7 @@ int main() {
         std::vector<int> seq{3};
 
         std::cout << "Sequence: ";
-        std::copy(std::begin(seq), std::end(seq), std::ostream_iterator<int>{std::cout, " "});
+        TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(seq), std::end(seq));
 
         execute(seq, std::vector<int>{3});
     }
@@ -119,7 +141,7 @@ int main() {
         std::vector<int> seq{3, 3};
 
         std::cout << "Sequence: ";
-        std::copy(std::begin(seq), std::end(seq), std::ostream_iterator<int>(std::cout, " "));
+        TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(seq), std::end(seq));
 
         execute(seq, std::vector<int>{3, 3});
     }
@@ -133,7 +155,7 @@ int main() {
         std::vector<int> seq{1, 2, 3, 4, 5, 6, 7, 8, 9};
 
         std::cout << "Sequence: ";
-        std::copy(std::begin(seq), std::end(seq), std::ostream_iterator<int>(std::cout, " "));
+        TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(seq), std::end(seq));
 
         execute(seq, std::vector<int>{2, 4, 6, 8, 1, 3, 5, 7, 9});
     }
@@ -144,32 +166,27 @@ int main() {
     {
         std::cout << "\n\nTEST PHASE 6: test with long sequence loaded from a file\n\n";
 
-        std::ifstream file("../code/test_data.txt");
+        // read the input sequence from file
+        std::vector<int> seq;
 
-        if (!file) {
+        if (!TND004::load_ints("../code/test_data.txt", seq)) {
             std::cout << "Could not open test test_data.txt!!\n";
             return 0;
         }
 
-        // read the input sequence from file
-        std::vector<int> seq{std::istream_iterator<int>{file}, std::istream_iterator<int>()};
-        file.close();
-
         std::cout << "Number of items in the sequence: " << seq.size() << '\n';
 
         // display sequence
         // std::for_each(std::begin(seq), std::end(seq), Formatter<int>(std::cout, 8, 5));
 
         // read the result sequence from file
-        file.open("../code/test_result.txt");
+        std::vector<int> res;
 
-        if (!file) {
+        if (!TND004::load_ints("../code/test_result.txt", res)) {
             std::cout << "Could not open test_result.txt!!\n";
             return 0;
         }
 
-        std::vector<int> res{std::istream_iterator<int>{file}, std::istream_iterator<int>()};
-
         std::cout << "Number of items in the result sequence: " << res.size() << '\n';
 
         // display sequence
@@ -179,6 +196,488 @@ int main() {
 
         execute(seq, res);
     }
+
+    ///*****************************************************
+    // * TEST PHASE 7                                       *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 7: generic algorithms with a bidirectional sequence and a lambda\n\n";
+
+        const std::list<int> seq{1, 2, 3, 4, 5, 6, 7, 8, 9};
+        const std::list<int> res{3, 6, 9, 1, 2, 4, 5, 7, 8};
+        auto div3 = [](int i) { return i % 3 == 0; };
+
+        std::list<int> L{seq};
+        [[maybe_unused]] auto it = TND004::stable_partition_iterative(std::begin(L), std::end(L), div3);
+        assert(L == res && *it == 1);
+
+        L = seq;
+        it = TND004::stable_partition(std::begin(L), std::end(L), div3);
+        assert(L == res && *it == 1);
+
+        std::cout << "Sequence: ";
+        TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(L), std::end(L));
+        std::cout << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 8                                       *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 8: iterative algorithm with a reused scratch buffer\n\n";
+
+        std::vector<int> scratch;
+        scratch.reserve(8);
+        [[maybe_unused]] const int* buffer = scratch.data();
+
+        // the scratch buffer is large enough for every batch, so it is never reallocated
+        for (int batch = 0; batch < 4; ++batch) {
+            std::vector<int> seq{1 + batch, 2, 3, 4, 5, 6, 7, 8, 9};
+            [[maybe_unused]] auto it = TND004::stable_partition_iterative(std::begin(seq), std::end(seq), even, scratch);
+            assert(std::is_partitioned(std::begin(seq), std::end(seq), even));
+            assert(std::partition_point(std::begin(seq), std::end(seq), even) == it);
+            assert(scratch.data() == buffer && scratch.empty());
+        }
+
+        std::cout << "Scratch buffer reused, capacity " << scratch.capacity() << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 9                                       *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 9: parallel algorithms with a pool of 4 threads\n\n";
+
+        std::vector<int> seq(1'000'000);
+        std::mt19937 gen{9};
+        std::generate(std::begin(seq), std::end(seq), [&gen] { return static_cast<int>(gen() % 10000); });
+
+        std::vector<int> res{seq};
+        std::stable_partition(std::begin(res), std::end(res), even);
+
+        TND004::TaskPool pool{4};
+        for (std::size_t cutoff : {std::size_t{1000}, TND004::parallel_cutoff}) {
+            std::vector<int> V{seq};
+            [[maybe_unused]] auto it = TND004::parallel_stable_partition(std::begin(V), std::end(V), even, pool, cutoff);
+            assert(V == res);
+            assert(it == std::partition_point(std::begin(V), std::end(V), even));
+
+            V = seq;
+            it = TND004::scan_stable_partition(std::begin(V), std::end(V), even, pool, cutoff);
+            assert(V == res);
+            assert(it == std::partition_point(std::begin(V), std::end(V), even));
+        }
+
+        // the items need not be default constructible
+        std::vector<std::reference_wrapper<const int>> refs(std::begin(seq), std::end(seq));
+        TND004::scan_stable_partition(std::begin(refs), std::end(refs), [](int i) { return even(i); }, pool, 1000);
+        assert(std::equal(std::begin(refs), std::end(refs), std::begin(res)));
+
+        std::cout << "Number of items partitioned: " << seq.size() << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 10                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 10: vectorized kernels, compared with std::stable_partition\n\n";
+
+        std::mt19937 gen{10};
+        std::uniform_int_distribution<int> dist{-1000, 1000};
+
+        std::vector<int> ints(100'003);  // the size is not a multiple of the vector width
+        std::generate(std::begin(ints), std::end(ints), [&] { return dist(gen); });
+
+        std::vector<float> floats(100'003);
+        std::generate(std::begin(floats), std::end(floats), [&] { return dist(gen) / 10.0f; });
+
+        // partition a copy of seq with the kernels and check it against std::stable_partition
+        auto check = [](const auto& seq, auto p) {
+            auto res{seq};
+            std::stable_partition(std::begin(res), std::end(res), p);
+
+            auto V{seq};
+            [[maybe_unused]] auto it = TND004::stable_partition_iterative(std::begin(V), std::end(V), p);
+            assert(V == res);
+            assert(it == std::partition_point(std::begin(V), std::end(V), p));
+        };
+
+        using TND004::simd::isa;
+        for (isa i : {isa::scalar, isa::avx2, isa::avx512}) {
+            TND004::simd::set_isa(i);
+
+            check(ints, TND004::is_even{});
+            check(ints, TND004::less_than<int>{17});
+            check(ints, TND004::in_range<int>{-250, 400});
+            check(floats, TND004::less_than<float>{-3.5f});
+            check(floats, TND004::in_range<float>{-20.0f, 55.5f});
+            check(std::vector<int>{1, 2, 3}, TND004::is_even{});
+        }
+        TND004::simd::set_isa(TND004::simd::detected_isa());
+
+        std::cout << "Detected instruction set: ";
+        switch (TND004::simd::detected_isa()) {
+            case isa::avx512: std::cout << "AVX-512\n"; break;
+            case isa::avx2: std::cout << "AVX2\n"; break;
+            default: std::cout << "scalar\n"; break;
+        }
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 11                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 11: adaptive algorithm with a memory budget, bottom-up algorithm\n\n";
+
+        std::vector<int> seq(100'000);
+        std::mt19937 gen{11};
+        std::generate(std::begin(seq), std::end(seq), [&gen] { return static_cast<int>(gen() % 10000); });
+
+        std::vector<int> res{seq};
+        std::stable_partition(std::begin(res), std::end(res), even);
+
+        // no buffer, a buffer smaller than the sequence, a buffer for the whole sequence
+        for (std::size_t budget : {std::size_t{0}, std::size_t{1024}, std::size_t{64 * 1024}, std::size_t{1} << 20}) {
+            std::vector<int> V{seq};
+            [[maybe_unused]] auto it = TND004::stable_partition_adaptive(std::begin(V), std::end(V), even, budget);
+            assert(V == res);
+            assert(it == std::partition_point(std::begin(V), std::end(V), even));
+
+            std::list<int> L(std::begin(seq), std::end(seq));
+            TND004::stable_partition_adaptive(std::begin(L), std::end(L), even, budget);
+            assert(std::equal(std::begin(L), std::end(L), std::begin(res), std::end(res)));
+        }
+
+        // bottom-up algorithm with a few leaf sizes
+        for (std::size_t leaf_bytes : {std::size_t{1}, std::size_t{100}, std::size_t{4096}}) {
+            std::vector<int> V{seq};
+            [[maybe_unused]] auto it = TND004::stable_partition_bottom_up(std::begin(V), std::end(V), even, leaf_bytes);
+            assert(V == res);
+            assert(it == std::partition_point(std::begin(V), std::end(V), even));
+
+            std::list<int> L(std::begin(seq), std::end(seq));
+            TND004::stable_partition_bottom_up(std::begin(L), std::end(L), even, leaf_bytes);
+            assert(std::equal(std::begin(L), std::end(L), std::begin(res), std::end(res)));
+        }
+
+        std::cout << "Number of items partitioned: " << seq.size() << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 12                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 12: out-of-core stable partition of test_data.txt\n\n";
+
+        std::vector<int> res;
+
+        if (!TND004::load_ints("../code/test_result.txt", res)) {
+            std::cout << "Could not open test_result.txt!!\n";
+            return 0;
+        }
+
+        // tiny chunks, such that many ints are split between two chunks
+        const std::string output{"test_data_partitioned.txt"};
+        std::size_t count = TND004::external_stable_partition("../code/test_data.txt", output, even, 64);
+
+        std::vector<int> seq;
+        TND004::load_ints(output, seq);
+        std::remove(output.c_str());
+
+        assert(seq == res);
+        assert(count == static_cast<std::size_t>(std::partition_point(std::begin(res), std::end(res), even) -
+                                                 std::begin(res)));
+
+        // many chunks with only whitespace, then an invalid int: the spill file is removed
+        const std::string input{"test_data_spaces.txt"};
+        std::ofstream{input} << "1 2 3" << std::string(100'000, ' ') << "4 x5\n";
+        try {
+            TND004::external_stable_partition(input, output, even, 64);
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+        assert(!std::ifstream{output + ".uneven.tmp"});
+        std::remove(input.c_str());
+        std::remove(output.c_str());
+
+        std::cout << "Number of items satisfying the predicate: " << count << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 13                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 13: binary int files, loaded and memory-mapped\n\n";
+
+        std::vector<int> seq;
+        std::vector<int> res;
+
+        if (!TND004::load_ints("../code/test_data.txt", seq) || !TND004::load_ints("../code/test_result.txt", res)) {
+            std::cout << "Could not open test_data.txt or test_result.txt!!\n";
+            return 0;
+        }
+
+        const std::string binary{"test_data.bin"};
+        [[maybe_unused]] bool saved = TND004::save_ints_binary(binary, seq);
+        assert(saved);
+
+        {  // partition the file in place, no parsing at all
+            TND004::MappedIntFile mapped{binary};
+            assert(mapped && mapped.size() == seq.size());
+            TND004::stable_partition_iterative(mapped.begin(), mapped.end(), TND004::is_even{});
+        }
+
+        std::vector<int> partitioned;
+        [[maybe_unused]] bool loaded = TND004::load_ints_binary(binary, partitioned);
+        assert(loaded && partitioned == res);
+
+        // feed the harness from the binary file
+        TND004::save_ints_binary(binary, seq);
+        TND004::load_ints_binary(binary, seq);
+        std::remove(binary.c_str());
+
+        execute(seq, res);
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 14                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 14: multi-way stable partition into 7 buckets\n\n";
+
+        std::vector<int> seq(100'000);
+        std::mt19937 gen{14};
+        std::generate(std::begin(seq), std::end(seq), [&gen] { return static_cast<int>(gen() % 10000); });
+
+        auto shard = [](int i) { return i % 7; };
+
+        // expected result: stable sort on the bucket
+        std::vector<int> res{seq};
+        std::stable_sort(std::begin(res), std::end(res), [&](int a, int b) { return shard(a) < shard(b); });
+
+        std::vector<int> V{seq};
+        auto bounds = TND004::stable_partition_multiway(std::begin(V), std::end(V), shard, 7);
+        assert(V == res);
+
+        for (std::size_t k = 0; k < 7; ++k) {
+            assert(std::all_of(bounds[k], bounds[k + 1], [&](int i) { return shard(i) == static_cast<int>(k); }));
+        }
+
+        TND004::TaskPool pool{4};
+        V = seq;
+        auto pbounds = TND004::parallel_stable_partition_multiway(std::begin(V), std::end(V), shard, 7, pool, 1000);
+        assert(V == res);
+        assert(pbounds == bounds);  // V keeps its storage, so the iterators can be compared
+
+        std::cout << "Items in bucket 0: " << bounds[1] - bounds[0] << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 15                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 15: strings are moved, not copied\n\n";
+
+        // strings longer than the small string buffer: every copy would allocate
+        std::vector<std::string> seq;
+        std::mt19937 gen{15};
+        for (int i = 0; i < 10'000; ++i) {
+            seq.push_back(std::string(40, 'a') + std::to_string(gen() % 100000));
+        }
+
+        auto ends_even = [](const std::string& s) { return (s.back() - '0') % 2 == 0; };
+
+        std::vector<std::string> res{seq};
+        std::stable_partition(std::begin(res), std::end(res), ends_even);
+
+        std::vector<std::string> V{seq};
+        TND004::stable_partition_iterative(std::begin(V), std::end(V), ends_even);  // warm-up: the arena grows
+
+        V = seq;
+        [[maybe_unused]] std::size_t before = TND004::allocation_count();
+        TND004::stable_partition_iterative(std::begin(V), std::end(V), ends_even);
+        assert(TND004::allocation_count() == before);
+        assert(V == res);
+
+        V = seq;
+        before = TND004::allocation_count();
+        TND004::stable_partition(std::begin(V), std::end(V), ends_even);
+        assert(TND004::allocation_count() == before);
+        assert(V == res);
+
+        V = seq;
+        before = TND004::allocation_count();
+        TND004::stable_partition_adaptive(std::begin(V), std::end(V), ends_even, 4096);
+        assert(TND004::allocation_count() == before + 1);  // the buffer
+        assert(V == res);
+
+        // a few buffers, independent of the number of strings
+        V = seq;
+        TND004::TaskPool pool{1};
+        before = TND004::allocation_count();
+        TND004::scan_stable_partition(std::begin(V), std::end(V), ends_even, pool, 1000);
+        assert(TND004::allocation_count() - before <= 3);
+        assert(V == res);
+
+        std::cout << "Number of strings partitioned: " << seq.size() << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 16                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 16: online stable partition\n\n";
+
+        std::mt19937 gen{16};
+        std::vector<int> seq;
+        TND004::PartitionedSequence<int, TND004::is_even> S;
+
+        assert(S.empty() && S.begin() == S.end());
+
+        // read out the partitioned order after every batch
+        for (int batch = 0; batch < 50; ++batch) {
+            for (int i = 0; i < batch * 7; ++i) {
+                const int x = static_cast<int>(gen() % 1000);
+                seq.push_back(x);
+                S.push_back(x);
+            }
+
+            std::vector<int> res{seq};
+            TND004::stable_partition_iterative(std::begin(res), std::end(res), even);
+
+            assert(S.size() == seq.size());
+            assert(std::equal(S.begin(), S.end(), std::begin(res), std::end(res)));
+            assert(std::equal(std::make_reverse_iterator(S.end()), std::make_reverse_iterator(S.begin()),
+                              std::rbegin(res), std::rend(res)));
+            assert(static_cast<std::size_t>(std::distance(S.begin(), S.partition_point())) == S.even_size());
+            assert(S.to_vector() == res);
+        }
+
+        std::cout << "Number of items pushed: " << S.size() << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 17                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 17: batched partition of segments\n\n";
+
+        std::mt19937 gen{17};
+        std::vector<int> values;
+        std::vector<std::size_t> offsets{0};
+
+        // segments of 0 to 1000 items
+        for (int s = 0; s < 2000; ++s) {
+            const std::size_t length = gen() % 1001;
+            for (std::size_t i = 0; i < length; ++i) {
+                values.push_back(static_cast<int>(gen() % 1000));
+            }
+            offsets.push_back(values.size());
+        }
+
+        // expected result: partition every segment separately
+        std::vector<int> res{values};
+        std::vector<std::size_t> res_split;
+        for (std::size_t s = 0; s + 1 < offsets.size(); ++s) {
+            auto it = std::stable_partition(std::begin(res) + offsets[s], std::begin(res) + offsets[s + 1], even);
+            res_split.push_back(static_cast<std::size_t>(it - std::begin(res)));
+        }
+
+        std::vector<int> V{values};
+        [[maybe_unused]] auto split = TND004::stable_partition_batched(V, offsets, even);
+        assert(V == res && split == res_split);
+
+        V = values;
+        split = TND004::stable_partition_batched(V, offsets, TND004::is_even{});  // vectorized
+        assert(V == res && split == res_split);
+
+        TND004::TaskPool pool{4};
+        for (std::size_t grain : {std::size_t{1}, std::size_t{5000}, std::size_t{1} << 20}) {
+            V = values;
+            split = TND004::parallel_stable_partition_batched(V, offsets, TND004::is_even{}, pool, grain);
+            assert(V == res && split == res_split);
+        }
+
+        std::vector<std::size_t> no_segments{0};
+        assert(TND004::stable_partition_batched(V, no_segments, even).empty());
+
+        std::cout << "Number of segments partitioned: " << offsets.size() - 1 << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 18                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 18: buffered int writer\n\n";
+
+        std::mt19937 gen{18};
+        std::vector<int> seq{0, -1, 7, 123456789, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()};
+        for (int i = 0; i < 10'000; ++i) {
+            seq.push_back(static_cast<int>(gen()));
+        }
+
+        for (int width : {0, 4, 8, 15}) {
+            for (int per_line : {1, 5, 7}) {
+                std::ostringstream expected;
+                std::for_each(std::begin(seq), std::end(seq), Formatter<int>(expected, width, per_line));
+
+                // small buffer, such that it is written many times
+                std::ostringstream os;
+                {
+                    TND004::IntWriter out{os, width, per_line, {}, 64};
+                    out.write(std::begin(seq), std::end(seq));
+                }
+                assert(os.str() == expected.str());
+            }
+        }
+
+        std::ostringstream expected;
+        std::copy(std::begin(seq), std::end(seq), std::ostream_iterator<int>{expected, " "});
+        std::ostringstream os;
+        TND004::IntWriter{os, 0, 0, " "}.write(std::begin(seq), std::end(seq));
+        assert(os.str() == expected.str());
+
+        std::cout << "Number of items written: " << seq.size() << '\n';
+    }
+
+    ///*****************************************************
+    // * TEST PHASE 19                                      *
+    // ******************************************************/
+    {
+        std::cout << "\n\nTEST PHASE 19: instrumentation counters\n\n";
+
+        TND004::PartitionStats& stats = TND004::partition_stats();
+        const std::vector<int> seq{1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+        std::vector<int> V{seq};
+        stats.reset();
+        TND004::release_scratch_arena<int>();
+        TND004::stable_partition_iterative(V, even);
+
+#if TND004_PARTITION_STATS
+        // 4 even items moved forward, 5 uneven items moved to scratch and back
+        assert(stats.predicate_calls == 9 && stats.moves == 4 + 2 * 5);
+        assert(stats.rotations == 0 && stats.bytes_allocated >= 5 * sizeof(int));
+
+        V = {1, 2, 3, 4, 5, 6, 7, 8};
+        stats.reset();
+        TND004::stable_partition(std::begin(V), std::end(V), even);
+        assert(stats.predicate_calls == 8 && stats.max_depth == 4);  // 8, 4, 2 and 1 items
+        assert(stats.rotations == 7 && stats.bytes_allocated == 0);
+        assert(stats.rotated_items == stats.moves);
+        assert(stats.to_json().find("\"rotations\":7,") != std::string::npos);
+
+        V = seq;
+        stats.reset();
+        TND004::stable_partition_iterative(std::begin(V), std::end(V), TND004::is_even{});
+        assert(stats.predicate_calls == 9 && stats.moves == 2 * 9 - 4);
+
+        std::cout << "Counters: " << stats.to_json() << '\n';
+#else
+        assert(stats.predicate_calls == 0 && stats.moves == 0);
+        std::cout << "Instrumentation disabled (configure with -DTND004_PARTITION_STATS=ON)\n";
+#endif
+    }
 }
 
 /****************************************
@@ -191,87 +690,72 @@ bool even(int i) {
 
 // Used for testing
 void execute(std::vector<int>& V, const std::vector<int>& res) {
+    const std::vector<int> V0{V};
     std::vector<int> _copy{V};
 
     std::cout << "\n\nIterative stable partition\n";
     TND004::stable_partition_iterative(V, even);
-    std::copy(std::begin(V), std::end(V), std::ostream_iterator<int>{std::cout, " "});
+    TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(V), std::end(V));
     assert(V == res);  // compare with the expected result
 
     std::cout << std::endl;
     std::cout <<  "Divide-and-conquer stable partition\n";
     TND004::stable_partition(_copy, even);
-    std::copy(std::begin(_copy), std::end(_copy), std::ostream_iterator<int>{std::cout, " "});
+    TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(_copy), std::end(_copy));
+    assert(_copy == res);  // compare with the expected result
+
+    std::cout << std::endl;
+    std::cout << "Bottom-up divide-and-conquer stable partition\n";
+    _copy = V0;
+    // leaves of two ints, such that the test sequences also need several merge levels
+    TND004::stable_partition_bottom_up(std::begin(_copy), std::end(_copy), even, 2 * sizeof(int));
+    TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(_copy), std::end(_copy));
+    assert(_copy == res);  // compare with the expected result
+
+    std::cout << std::endl;
+    std::cout << "Parallel divide-and-conquer stable partition\n";
+    _copy = V0;
+    // small cutoff, such that the test sequences are also split between threads
+    TND004::parallel_stable_partition(std::begin(_copy), std::end(_copy), even, TND004::default_pool(), 8);
+    TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(_copy), std::end(_copy));
+    assert(_copy == res);  // compare with the expected result
+
+    std::cout << std::endl;
+    std::cout << "Scan-based stable partition\n";
+    _copy = V0;
+    TND004::scan_stable_partition(std::begin(_copy), std::end(_copy), even, TND004::default_pool(), 8);
+    TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(_copy), std::end(_copy));
     assert(_copy == res);  // compare with the expected result
+
+    std::cout << std::endl;
+    std::cout << "Vectorized stable partition\n";
+    _copy = V0;
+    TND004::stable_partition_iterative(std::begin(_copy), std::end(_copy), TND004::is_even{});
+    TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(_copy), std::end(_copy));
+    assert(_copy == res);  // compare with the expected result
+
+    std::cout << std::endl;
+    std::cout << "Multi-way stable partition with two buckets\n";
+    _copy = V0;
+    auto bounds = TND004::stable_partition_multiway(std::begin(_copy), std::end(_copy),
+                                                    [](int i) { return even(i) ? 0 : 1; }, 2);
+    TND004::IntWriter{std::cout, 0, 0, " "}.write(std::begin(_copy), std::end(_copy));
+    assert(_copy == res);  // compare with the expected result
+    assert(bounds.size() == 3 && bounds[0] == std::begin(_copy) && bounds[2] == std::end(_copy));
+    assert(bounds[1] == std::partition_point(std::begin(_copy), std::end(_copy), even));
 }
 
 // Iterative algorithm
 void TND004::stable_partition_iterative(std::vector<int>& V, std::function<bool(int)> p) {
-    // IMPLEMENT before Lab1 HA
-    //empty vector, do nothing
-    if (size(V) == 0) {
-        return;
-    }
-    //create 2 new vectors with reserved size of the vector V, which means that it has already allocated memory of that size. 
-    std::vector<int> even;
-    std::vector<int> uneven;
-    even.reserve(V.size());
-    uneven.reserve(V.size());
-
-
-    for (std::vector<int>::iterator it = V.begin(); it != V.end(); ++it) {
-        if (p(*it)) { //even
-            even.push_back(*it);
-        }
-        else { //uneven
-            uneven.push_back(*it);
-        }
-    }
-    //merge the two vectors
-    even.insert(even.end(), uneven.begin(), uneven.end());
-    V = even; 
+    TND004::stable_partition_iterative(std::begin(V), std::end(V), p);
 }
 
 // Auxiliary function that performs the stable partition recursively
-// Divide-and-conquer algorithm: stable-partition the sub-sequence starting at first and ending at
-// last-1.
-// If there are items with property p then return an iterator to the end of the block
-// containing the items with property p. If there are no items with property p then return first.
+// The explicit template arguments select the generic version in stable_partition.h,
+// otherwise this function would call itself
 std::vector<int>::iterator TND004::stable_partition(std::vector<int>::iterator first,
                                             std::vector<int>::iterator last,
                                             std::function<bool(int)> p) {
-    // Base Case 0: The vector is empty
-    if (std::distance(first, last) == 0) {
-        std::cout << "Vector is empty" << std::endl;
-        return first;
-    }
-
-    // Base Case 1: Both iterators are on the same element (one element)
-    // first points to the beginning of the element, last points to the end of the element = resulting in a distanse of 1
-    if (std::distance(first,last) == 1) {
-        //Checks if even --> return iterator pointing to the end of the block, including the element
-        if(p(*first)){
-            return last;
-        }
-
-        //Checks if odd --> return iterator pointing to the beginning of the block, not including the element
-        else {
-            return first;
-        }
-    }
-
-    // if we're not at the base case, meaning not empty and more than one element = then recursive
-    // split the elements into two parts until there are only one element left --> base case
-    else { 
-        //mid is the last element of the left half, and the first element of the right half
-        std::vector<int>::iterator mid = (first + (std::distance(first, last)) / 2);
-        std::vector<int>::iterator it1;
-        std::vector<int>::iterator it3;
-
-            //Recursive, calls itself for each split parts
-            it1 = stable_partition(first, mid, p);
-            it3 = stable_partition(mid, last, p);
-            
-        return std::rotate(it1, mid, it3);
-    }
-}
\ No newline at end of file
+    return TND004::stable_partition<std::vector<int>::iterator, const std::function<bool(int)>&>(
+        first, last, p);
+}
@@ -0,0 +1,145 @@
+// multiway_partition.h : stable k-way partition
+// Route the items into K buckets given by a classifier, keeping the relative order
+// of the items inside every bucket
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "task_pool.h"
+
+namespace TND004 {
+
+    /** Stable k-way partition
+     *
+     * Reorder [first, last) such that the items of bucket 0 come first, then the items of bucket 1, ...
+     * Three passes: histogram of the buckets, exclusive prefix sum of the histogram,
+     * scatter every item to its destination in a buffer, which is then moved back
+     * With K == 2 and classify(x) = p(x) ? 0 : 1 the result is the same as TND004::stable_partition
+     * T must be default constructible (the buffer is value-initialized)
+     * \param classify callable returning the bucket of an item, in [0, K)
+     * \param K number of buckets
+     * Return K+1 iterators: bucket k is [result[k], result[k+1])
+     */
+    template <typename RandomIt, typename Classify>
+    std::vector<RandomIt> stable_partition_multiway(RandomIt first, RandomIt last, Classify classify,
+                                                    std::size_t K) {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+
+        const auto n = static_cast<std::size_t>(last - first);
+
+        // Pass 1: bucket of every item (the classifier is called once per item) and histogram
+        std::vector<std::uint32_t> bucket(n);
+        std::vector<std::size_t> start(K + 1, 0);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            bucket[i] = static_cast<std::uint32_t>(classify(first[i]));
+            assert(bucket[i] < K);
+            ++start[bucket[i] + 1];
+        }
+
+        // Pass 2: exclusive prefix sum, start[k] is the position of the first item of bucket k
+        for (std::size_t k = 0; k < K; ++k) {
+            start[k + 1] += start[k];
+        }
+
+        // Pass 3: scatter to the buffer and move back
+        std::vector<T> buffer(n);
+        std::vector<std::size_t> pos(start.begin(), start.end() - 1);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            buffer[pos[bucket[i]]++] = std::move(first[i]);
+        }
+        std::move(buffer.begin(), buffer.end(), first);
+
+        std::vector<RandomIt> bounds;
+        bounds.reserve(K + 1);
+        for (std::size_t s : start) {
+            bounds.push_back(first + s);
+        }
+        return bounds;
+    }
+
+    /** Parallel stable k-way partition
+     *
+     * Same as stable_partition_multiway, but the sequence is split in blocks of block_size items
+     * and every thread builds the histograms of its blocks
+     * Bucket k of block b starts after bucket k of the blocks before b, so that
+     * the scatter of every block can be done independently
+     * Extra memory: the buffer and one histogram of K counters per block
+     */
+    template <typename RandomIt, typename Classify>
+    std::vector<RandomIt> parallel_stable_partition_multiway(RandomIt first, RandomIt last, Classify classify,
+                                                             std::size_t K, TaskPool& pool,
+                                                             std::size_t block_size = std::size_t{1} << 16) {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+
+        const auto n = static_cast<std::size_t>(last - first);
+        block_size = std::max<std::size_t>(block_size, 1);
+        const std::size_t blocks = (n + block_size - 1) / block_size;
+
+        // Pass 1: bucket of every item and histogram of every block, hist[b * K + k]
+        std::vector<std::uint32_t> bucket(n);
+        std::vector<std::size_t> hist(blocks * K, 0);
+
+        parallel_for(pool, 0, blocks, [&](std::size_t b) {
+            const std::size_t lo = b * block_size;
+            const std::size_t hi = std::min(n, lo + block_size);
+            std::size_t* h = hist.data() + b * K;
+
+            for (std::size_t i = lo; i < hi; ++i) {
+                bucket[i] = static_cast<std::uint32_t>(classify(first[i]));
+                assert(bucket[i] < K);
+                ++h[bucket[i]];
+            }
+        });
+
+        // Pass 2: exclusive prefix sum in bucket-major order, hist[b * K + k] becomes the
+        // destination of the first item of bucket k in block b
+        std::vector<std::size_t> start(K + 1, 0);
+        std::size_t sum = 0;
+
+        for (std::size_t k = 0; k < K; ++k) {
+            start[k] = sum;
+            for (std::size_t b = 0; b < blocks; ++b) {
+                const std::size_t count = hist[b * K + k];
+                hist[b * K + k] = sum;
+                sum += count;
+            }
+        }
+        start[K] = sum;
+
+        // Pass 3: scatter to the buffer and move back
+        std::vector<T> buffer(n);
+
+        parallel_for(pool, 0, blocks, [&](std::size_t b) {
+            const std::size_t lo = b * block_size;
+            const std::size_t hi = std::min(n, lo + block_size);
+            std::size_t* pos = hist.data() + b * K;
+
+            for (std::size_t i = lo; i < hi; ++i) {
+                buffer[pos[bucket[i]]++] = std::move(first[i]);
+            }
+        });
+
+        parallel_for(pool, 0, blocks, [&](std::size_t b) {
+            const std::size_t lo = b * block_size;
+            const std::size_t hi = std::min(n, lo + block_size);
+            std::move(buffer.begin() + lo, buffer.begin() + hi, first + lo);
+        });
+
+        std::vector<RandomIt> bounds;
+        bounds.reserve(K + 1);
+        for (std::size_t s : start) {
+            bounds.push_back(first + s);
+        }
+        return bounds;
+    }
+
+}  // namespace TND004
@@ -0,0 +1,178 @@
+// parallel_partition.h : multi-threaded stable partition algorithms
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "stable_partition.h"
+#include "task_pool.h"
+
+namespace TND004 {
+
+    // Default size of the sub-sequences that are processed by one thread only
+    constexpr std::size_t parallel_cutoff = std::size_t{1} << 16;
+
+    /** Reverse the sequence [first, last) in parallel
+     *
+     * The swaps of the outer pairs are split in blocks of at most cutoff pairs
+     */
+    template <typename RandomIt>
+    void parallel_reverse(RandomIt first, RandomIt last, TaskPool& pool, std::size_t cutoff) {
+        const auto n = last - first;
+        const auto pairs = n / 2;
+
+        // swap the pairs (first[i], last[-1-i]) for i in [lo, hi)
+        auto swap_pairs = [first, last, &pool, cutoff](auto& self, decltype(n) lo, decltype(n) hi) -> void {
+            if (static_cast<std::size_t>(hi - lo) <= cutoff) {
+                for (auto i = lo; i < hi; ++i) {
+                    std::iter_swap(first + i, last - 1 - i);
+                }
+                return;
+            }
+
+            const auto mid = lo + (hi - lo) / 2;
+            pool.invoke([&] { self(self, lo, mid); }, [&] { self(self, mid, hi); });
+        };
+
+        swap_pairs(swap_pairs, decltype(n){0}, pairs);
+    }
+
+    /** Rotate the sequence [first, last) such that middle becomes the first item
+     *
+     * Large blocks are rotated with three parallel reversals, small blocks with std::rotate
+     * Return an iterator to the new position of the item pointed by first
+     */
+    template <typename RandomIt>
+    RandomIt parallel_rotate(RandomIt first, RandomIt middle, RandomIt last, TaskPool& pool,
+                             std::size_t cutoff = parallel_cutoff) {
+        if (first == middle) {
+            return last;
+        }
+        if (middle == last) {
+            return first;
+        }
+        if (static_cast<std::size_t>(last - first) <= cutoff) {
+            return std::rotate(first, middle, last);
+        }
+
+        pool.invoke([&] { parallel_reverse(first, middle, pool, cutoff); },
+                    [&] { parallel_reverse(middle, last, pool, cutoff); });
+        parallel_reverse(first, last, pool, cutoff);
+
+        return first + (last - middle);
+    }
+
+    /** Parallel divide-and-conquer algorithm
+     *
+     * Same algorithm as TND004::stable_partition, but both halves are partitioned concurrently
+     * Sub-sequences with at most cutoff items are partitioned sequentially with the iterative algorithm
+     * The result is identical to the sequential algorithms, since a stable partition is unique
+     * \param pool threads executing the recursive calls
+     * \param cutoff size of the sub-sequences partitioned sequentially (at least 1)
+     * Return an iterator to the first item not satisfying p
+     */
+    template <typename RandomIt, typename Pred>
+    RandomIt parallel_stable_partition(RandomIt first, RandomIt last, Pred p, TaskPool& pool,
+                                       std::size_t cutoff = parallel_cutoff) {
+        const auto n = last - first;
+
+        if (static_cast<std::size_t>(n) <= std::max<std::size_t>(cutoff, 1)) {
+            return TND004::stable_partition_iterative(first, last, p);
+        }
+
+        RandomIt mid = first + n / 2;
+        RandomIt it1;
+        RandomIt it3;
+
+        pool.invoke([&] { it1 = TND004::parallel_stable_partition<RandomIt, Pred>(first, mid, p, pool, cutoff); },
+                    [&] { it3 = TND004::parallel_stable_partition<RandomIt, Pred>(mid, last, p, pool, cutoff); });
+
+        return TND004::parallel_rotate(it1, mid, it3, pool, cutoff);
+    }
+
+    /** Scan-based parallel stable partition
+     *
+     * The sequence is split in blocks of block_size items and processed in three passes
+     * 1. evaluate p into an array of 0/1 flags and count the flags of each block
+     *    (branch-free loop over contiguous memory, auto-vectorized for simple predicates)
+     * 2. exclusive prefix sum of the block counts gives the destination of the first
+     *    even and the first uneven item of every block
+     *    Sequential: one count per block of block_size items, negligible next to passes 1 and 3
+     * 3. scatter every item to its final position in an uninitialized buffer, with a running
+     *    prefix sum of the flags inside the block, and move the buffer back
+     *    The items cannot be scattered in place: the destinations of a block overlap the items
+     *    of other blocks that may not have been read yet
+     * Work is O(N) with no rotations, passes 1 and 3 run in parallel
+     * Every item is moved twice, and the buffer holds N items
+     * Return an iterator to the first item not satisfying p
+     */
+    template <typename RandomIt, typename Pred>
+    RandomIt scan_stable_partition(RandomIt first, RandomIt last, Pred p, TaskPool& pool,
+                                   std::size_t block_size = parallel_cutoff) {
+        using T = typename std::iterator_traits<RandomIt>::value_type;
+
+        const auto n = static_cast<std::size_t>(last - first);
+        if (n == 0) {
+            return first;
+        }
+
+        block_size = std::max<std::size_t>(block_size, 1);
+        const std::size_t blocks = (n + block_size - 1) / block_size;
+
+        // Pass 1: flags and number of even items per block
+        std::vector<unsigned char> flags(n);
+        std::vector<std::size_t> even_before(blocks + 1, 0);
+
+        parallel_for(pool, 0, blocks, [&](std::size_t b) {
+            const std::size_t lo = b * block_size;
+            const std::size_t hi = std::min(n, lo + block_size);
+
+            std::size_t count = 0;
+            for (std::size_t i = lo; i < hi; ++i) {
+                flags[i] = static_cast<unsigned char>(p(first[i]) ? 1 : 0);
+                count += flags[i];
+            }
+            even_before[b + 1] = count;
+        });
+
+        // Pass 2: exclusive prefix sum of the block counts
+        for (std::size_t b = 0; b < blocks; ++b) {
+            even_before[b + 1] += even_before[b];
+        }
+        const std::size_t total_even = even_before[blocks];
+
+        // Pass 3: scatter to the buffer and move back
+        // raw storage: T need not be default constructible, and the items are not constructed twice
+        auto deallocate = [n](T* q) { std::allocator<T>{}.deallocate(q, n); };
+        const std::unique_ptr<T, decltype(deallocate)> buffer{std::allocator<T>{}.allocate(n), deallocate};
+
+        parallel_for(pool, 0, blocks, [&](std::size_t b) {
+            const std::size_t lo = b * block_size;
+            const std::size_t hi = std::min(n, lo + block_size);
+
+            std::size_t even_pos = even_before[b];
+            std::size_t uneven_pos = total_even + (lo - even_before[b]);  // uneven items before the block
+
+            for (std::size_t i = lo; i < hi; ++i) {
+                const std::size_t dest = flags[i] ? even_pos++ : uneven_pos++;
+                ::new (static_cast<void*>(buffer.get() + dest)) T(std::move(first[i]));
+            }
+        });
+
+        parallel_for(pool, 0, blocks, [&](std::size_t b) {
+            const std::size_t lo = b * block_size;
+            const std::size_t hi = std::min(n, lo + block_size);
+            std::move(buffer.get() + lo, buffer.get() + hi, first + lo);
+            std::destroy(buffer.get() + lo, buffer.get() + hi);
+        });
+
+        return first + total_even;
+    }
+
+}  // namespace TND004
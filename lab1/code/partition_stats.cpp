@@ -0,0 +1,53 @@
+#include "partition_stats.h"
+
+#include <algorithm>
+
+namespace TND004 {
+
+    namespace {
+
+        thread_local std::size_t depth = 0;  // current recursion depth
+
+    }  // namespace
+
+    std::string PartitionStats::to_json() const {
+        std::string json = "{";
+        auto field = [&json](const char* name, std::size_t value) {
+            if (json.size() > 1) {
+                json += ',';
+            }
+            json += '"';
+            json += name;
+            json += "\":";
+            json += std::to_string(value);
+        };
+
+        field("predicate_calls", predicate_calls);
+        field("moves", moves);
+        field("rotations", rotations);
+        field("rotated_items", rotated_items);
+        field("max_depth", max_depth);
+        field("bytes_allocated", bytes_allocated);
+        return json + '}';
+    }
+
+    PartitionStats& partition_stats() {
+        thread_local PartitionStats stats;
+        return stats;
+    }
+
+    namespace detail {
+
+        DepthGuard::DepthGuard() {
+            ++depth;
+            PartitionStats& stats = partition_stats();
+            stats.max_depth = std::max(stats.max_depth, depth);
+        }
+
+        DepthGuard::~DepthGuard() {
+            --depth;
+        }
+
+    }  // namespace detail
+
+}  // namespace TND004
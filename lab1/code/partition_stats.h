@@ -0,0 +1,61 @@
+// partition_stats.h : optional instrumentation of the stable partition algorithms
+// Compiled in only if TND004_PARTITION_STATS is defined to 1 (CMake option TND004_PARTITION_STATS),
+// otherwise the counting statements are removed by the preprocessor and cost nothing
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#ifndef TND004_PARTITION_STATS
+#define TND004_PARTITION_STATS 0
+#endif
+
+// Execute statement only if the instrumentation is compiled in
+#if TND004_PARTITION_STATS
+#define TND004_STATS(statement) statement
+#else
+#define TND004_STATS(statement) ((void)0)
+#endif
+
+namespace TND004 {
+
+    /** Counters of the work done by the stable partition algorithms
+     *
+     * The counters of the iterative and divide-and-conquer algorithms (stable_partition.h)
+     * are accumulated in one object per thread, see partition_stats()
+     */
+    struct PartitionStats {
+        std::size_t predicate_calls{0};
+        std::size_t moves{0};          // items moved, std::rotate is counted as one move per rotated item
+        std::size_t rotations{0};      // calls to std::rotate
+        std::size_t rotated_items{0};  // total length of the rotated ranges
+        std::size_t max_depth{0};      // deepest recursive call, 1 for the top-level call
+        std::size_t bytes_allocated{0};
+
+        void reset() {
+            *this = PartitionStats{};
+        }
+
+        // Return the counters as a JSON object, e.g. {"predicate_calls":10,"moves":12,...}
+        std::string to_json() const;
+    };
+
+    // Return the calling thread's counters, all zero if the instrumentation is not compiled in
+    PartitionStats& partition_stats();
+
+    namespace detail {
+
+        // Track the recursion depth of the divide-and-conquer algorithm, for PartitionStats::max_depth
+        class DepthGuard {
+        public:
+            DepthGuard();
+            ~DepthGuard();
+
+            DepthGuard(const DepthGuard&) = delete;
+            DepthGuard& operator=(const DepthGuard&) = delete;
+        };
+
+    }  // namespace detail
+
+}  // namespace TND004
@@ -0,0 +1,169 @@
+// partitioned_sequence.h : online stable partition
+// Container for items arriving one at a time, whose partitioned order can be read at any moment
+// without partitioning the whole sequence again
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace TND004 {
+
+    /** Class to represent a sequence kept stable-partitioned by a predicate
+     *
+     * The items satisfying p and the other items are stored in two chunked buffers (std::deque),
+     * such that push_back is O(1) amortized and never moves the items already stored
+     * Iteration visits the items satisfying p first, in insertion order, then the other items
+     * in insertion order, i.e. the result of a stable partition of the inserted sequence
+     * The items are read-only, since modifying them could break the partition
+     */
+    template <typename T, typename Pred>
+    class PartitionedSequence {
+    public:
+        class Iterator;
+
+        explicit PartitionedSequence(Pred p = Pred{}) : p_{std::move(p)} {
+        }
+
+        // Insert x at the end of its block
+        void push_back(const T& x) {
+            if (p_(x)) {
+                even_.push_back(x);
+            } else {
+                uneven_.push_back(x);
+            }
+        }
+
+        void push_back(T&& x) {
+            if (p_(x)) {
+                even_.push_back(std::move(x));
+            } else {
+                uneven_.push_back(std::move(x));
+            }
+        }
+
+        // Return number of items
+        std::size_t size() const {
+            return even_.size() + uneven_.size();
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        // Return number of items satisfying p
+        std::size_t even_size() const {
+            return even_.size();
+        }
+
+        void clear() {
+            even_.clear();
+            uneven_.clear();
+        }
+
+        Iterator begin() const {
+            return Iterator{this, 0};
+        }
+
+        Iterator end() const {
+            return Iterator{this, size()};
+        }
+
+        // Return an iterator to the first item not satisfying p
+        Iterator partition_point() const {
+            return Iterator{this, even_.size()};
+        }
+
+        /** Return the partitioned sequence in a vector
+         *
+         * The vector is allocated once and every item is copied once
+         */
+        std::vector<T> to_vector() const {
+            std::vector<T> result;
+            result.reserve(size());
+            result.insert(result.end(), even_.begin(), even_.end());
+            result.insert(result.end(), uneven_.begin(), uneven_.end());
+            return result;
+        }
+
+    private:
+        Pred p_;
+        std::deque<T> even_;    // items satisfying p
+        std::deque<T> uneven_;  // items not satisfying p
+
+        // Return the i-th item of the partitioned sequence
+        const T& at(std::size_t i) const {
+            return (i < even_.size()) ? even_[i] : uneven_[i - even_.size()];
+        }
+    };
+
+    /* ***********************************************************
+     * Class to represent a bi-directional iterator over the      *
+     * partitioned view of a PartitionedSequence                  *
+     * Iterators are invalidated by push_back and clear           *
+     * ***********************************************************/
+
+    template <typename T, typename Pred>
+    class PartitionedSequence<T, Pred>::Iterator {
+    public:
+        // Some properties for Iterator -- so that Iterator can be used with STL-algorithms
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+
+        Iterator() = default;
+
+        const T& operator*() const {
+            return seq_->at(index_);
+        }
+
+        const T* operator->() const {
+            return &seq_->at(index_);
+        }
+
+        bool operator==(const Iterator& it) const {
+            return seq_ == it.seq_ && index_ == it.index_;
+        }
+
+        bool operator!=(const Iterator& it) const {
+            return !(*this == it);
+        }
+
+        Iterator& operator++() {  // pre-increment
+            ++index_;
+            return *this;
+        }
+
+        Iterator operator++(int) {  // post-increment
+            Iterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        Iterator& operator--() {  // pre-decrement
+            --index_;
+            return *this;
+        }
+
+        Iterator operator--(int) {  // post-decrement
+            Iterator old = *this;
+            --index_;
+            return old;
+        }
+
+    private:
+        const PartitionedSequence* seq_{nullptr};
+        std::size_t index_{0};  // position in the partitioned sequence
+
+        Iterator(const PartitionedSequence* seq, std::size_t index) : seq_{seq}, index_{index} {
+        }
+
+        friend class PartitionedSequence;
+    };
+
+}  // namespace TND004
@@ -0,0 +1,305 @@
+#include "simd_partition.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// The vectorized kernels need the GCC/Clang target attribute and x86 intrinsics
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TND004_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define TND004_SIMD_X86 0
+#endif
+
+namespace TND004 {
+    namespace simd {
+
+        namespace {
+
+            /* **************************************** *
+             * Instruction set selection                *
+             * **************************************** */
+
+            isa detect() {
+#if TND004_SIMD_X86
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f")) {
+                    return isa::avx512;
+                }
+                if (__builtin_cpu_supports("avx2")) {
+                    return isa::avx2;
+                }
+#endif
+                return isa::scalar;
+            }
+
+            std::atomic<isa>& selected() {
+                static std::atomic<isa> s{detect()};
+                return s;
+            }
+
+            /* **************************************** *
+             * Scalar kernel                            *
+             * **************************************** */
+
+            // Also used for the tail that does not fill a vector register
+            template <typename T, typename Pred>
+            std::size_t partition_scalar(T* first, T* last, T* scratch, std::size_t even,
+                                         std::size_t uneven, Pred p) {
+                for (T* it = first + even + uneven; it != last; ++it) {
+                    if (p(*it)) {
+                        first[even++] = *it;
+                    } else {
+                        scratch[uneven++] = *it;
+                    }
+                }
+
+                std::copy(scratch, scratch + uneven, first + even);
+                return even;
+            }
+
+#if TND004_SIMD_X86
+
+            /* **************************************** *
+             * Lane tests                               *
+             * Return a bit mask of the lanes           *
+             * satisfying the predicate                 *
+             * **************************************** */
+
+            struct EvenTest {
+                is_even p;
+
+                __attribute__((target("avx2"))) unsigned avx2(__m256i v) const {
+                    const __m256i odd = _mm256_and_si256(v, _mm256_set1_epi32(1));
+                    const __m256i m = _mm256_cmpeq_epi32(odd, _mm256_setzero_si256());
+                    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+                }
+
+                __attribute__((target("avx512f"))) __mmask16 avx512(__m512i v) const {
+                    return _mm512_testn_epi32_mask(v, _mm512_set1_epi32(1));
+                }
+            };
+
+            struct IntLessTest {
+                less_than<int> p;
+
+                __attribute__((target("avx2"))) unsigned avx2(__m256i v) const {
+                    const __m256i m = _mm256_cmpgt_epi32(_mm256_set1_epi32(p.pivot), v);
+                    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+                }
+
+                __attribute__((target("avx512f"))) __mmask16 avx512(__m512i v) const {
+                    return _mm512_cmplt_epi32_mask(v, _mm512_set1_epi32(p.pivot));
+                }
+            };
+
+            struct IntRangeTest {
+                in_range<int> p;
+
+                __attribute__((target("avx2"))) unsigned avx2(__m256i v) const {
+                    const __m256i below = _mm256_cmpgt_epi32(_mm256_set1_epi32(p.lo), v);
+                    const __m256i above = _mm256_cmpgt_epi32(v, _mm256_set1_epi32(p.hi));
+                    const __m256i out = _mm256_or_si256(below, above);
+                    return ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(out))) & 0xFFu;
+                }
+
+                __attribute__((target("avx512f"))) __mmask16 avx512(__m512i v) const {
+                    return _mm512_cmpge_epi32_mask(v, _mm512_set1_epi32(p.lo)) &
+                           _mm512_cmple_epi32_mask(v, _mm512_set1_epi32(p.hi));
+                }
+            };
+
+            // Float tests compare the bits reinterpreted as floats, NaN never satisfies them
+            struct FloatLessTest {
+                less_than<float> p;
+
+                __attribute__((target("avx2"))) unsigned avx2(__m256i v) const {
+                    const __m256 m = _mm256_cmp_ps(_mm256_castsi256_ps(v), _mm256_set1_ps(p.pivot), _CMP_LT_OQ);
+                    return static_cast<unsigned>(_mm256_movemask_ps(m));
+                }
+
+                __attribute__((target("avx512f"))) __mmask16 avx512(__m512i v) const {
+                    return _mm512_cmp_ps_mask(_mm512_castsi512_ps(v), _mm512_set1_ps(p.pivot), _CMP_LT_OQ);
+                }
+            };
+
+            struct FloatRangeTest {
+                in_range<float> p;
+
+                __attribute__((target("avx2"))) unsigned avx2(__m256i v) const {
+                    const __m256 x = _mm256_castsi256_ps(v);
+                    const __m256 m = _mm256_and_ps(_mm256_cmp_ps(x, _mm256_set1_ps(p.lo), _CMP_GE_OQ),
+                                                   _mm256_cmp_ps(x, _mm256_set1_ps(p.hi), _CMP_LE_OQ));
+                    return static_cast<unsigned>(_mm256_movemask_ps(m));
+                }
+
+                __attribute__((target("avx512f"))) __mmask16 avx512(__m512i v) const {
+                    const __m512 x = _mm512_castsi512_ps(v);
+                    return _mm512_cmp_ps_mask(x, _mm512_set1_ps(p.lo), _CMP_GE_OQ) &
+                           _mm512_cmp_ps_mask(x, _mm512_set1_ps(p.hi), _CMP_LE_OQ);
+                }
+            };
+
+            /* **************************************** *
+             * AVX2 kernel                              *
+             * **************************************** */
+
+            // compress[m] moves the lanes selected by the 8-bit mask m to the front of the register
+            constexpr std::array<std::array<int, 8>, 256> make_compress_table() {
+                std::array<std::array<int, 8>, 256> table{};
+
+                for (int m = 0; m < 256; ++m) {
+                    int k = 0;
+                    for (int lane = 0; lane < 8; ++lane) {
+                        if (m & (1 << lane)) {
+                            table[m][k++] = lane;
+                        }
+                    }
+                }
+                return table;
+            }
+
+            alignas(32) constexpr std::array<std::array<int, 8>, 256> compress = make_compress_table();
+
+            // Store the first count lanes of v at dest, the other memory is not touched
+            __attribute__((target("avx2"))) void store_prefix(void* dest, __m256i v, int count) {
+                const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+                const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), lanes);
+                _mm256_maskstore_epi32(static_cast<int*>(dest), mask, v);
+            }
+
+            template <typename T, typename Test>
+            __attribute__((target("avx2,popcnt"))) std::size_t partition_avx2(T* first, T* last, T* scratch,
+                                                                               const Test& test) {
+                static_assert(sizeof(T) == 4, "32-bit lanes");
+
+                const std::size_t n = static_cast<std::size_t>(last - first);
+                std::size_t even = 0;
+                std::size_t uneven = 0;
+
+                for (std::size_t i = 0; i + 8 <= n; i += 8) {
+                    const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+                    const unsigned m = test.avx2(v);
+                    const int count = __builtin_popcount(m);
+
+                    // even lanes overwrite items that are already loaded, since even <= i
+                    const __m256i to_even = _mm256_permutevar8x32_epi32(
+                        v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress[m].data())));
+                    const __m256i to_uneven = _mm256_permutevar8x32_epi32(
+                        v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress[~m & 0xFFu].data())));
+
+                    store_prefix(first + even, to_even, count);
+                    store_prefix(scratch + uneven, to_uneven, 8 - count);
+                    even += static_cast<std::size_t>(count);
+                    uneven += static_cast<std::size_t>(8 - count);
+                }
+
+                return partition_scalar(first, last, scratch, even, uneven, test.p);
+            }
+
+            /* **************************************** *
+             * AVX-512 kernel                           *
+             * **************************************** */
+
+            template <typename T, typename Test>
+            __attribute__((target("avx512f,popcnt"))) std::size_t partition_avx512(T* first, T* last, T* scratch,
+                                                                                   const Test& test) {
+                static_assert(sizeof(T) == 4, "32-bit lanes");
+
+                const std::size_t n = static_cast<std::size_t>(last - first);
+                std::size_t even = 0;
+                std::size_t uneven = 0;
+
+                for (std::size_t i = 0; i + 16 <= n; i += 16) {
+                    const __m512i v = _mm512_loadu_si512(first + i);
+                    const __mmask16 m = test.avx512(v);
+                    const int count = __builtin_popcount(m);
+
+                    _mm512_mask_compressstoreu_epi32(first + even, m, v);
+                    _mm512_mask_compressstoreu_epi32(scratch + uneven, static_cast<__mmask16>(~m), v);
+                    even += static_cast<std::size_t>(count);
+                    uneven += static_cast<std::size_t>(16 - count);
+                }
+
+                return partition_scalar(first, last, scratch, even, uneven, test.p);
+            }
+
+            template <typename T, typename Test>
+            std::size_t dispatch(T* first, T* last, T* scratch, const Test& test) {
+                switch (current_isa()) {
+                    case isa::avx512:
+                        return partition_avx512(first, last, scratch, test);
+                    case isa::avx2:
+                        return partition_avx2(first, last, scratch, test);
+                    default:
+                        return partition_scalar(first, last, scratch, 0, 0, test.p);
+                }
+            }
+
+#endif  // TND004_SIMD_X86
+
+        }  // namespace
+
+        isa detected_isa() {
+            static const isa best = detect();
+            return best;
+        }
+
+        isa current_isa() {
+            return selected().load(std::memory_order_relaxed);
+        }
+
+        void set_isa(isa i) {
+            selected().store(std::min(i, detected_isa()), std::memory_order_relaxed);
+        }
+
+#if TND004_SIMD_X86
+
+        std::size_t stable_partition(int* first, int* last, int* scratch, is_even p) {
+            return dispatch(first, last, scratch, EvenTest{p});
+        }
+
+        std::size_t stable_partition(int* first, int* last, int* scratch, less_than<int> p) {
+            return dispatch(first, last, scratch, IntLessTest{p});
+        }
+
+        std::size_t stable_partition(int* first, int* last, int* scratch, in_range<int> p) {
+            return dispatch(first, last, scratch, IntRangeTest{p});
+        }
+
+        std::size_t stable_partition(float* first, float* last, float* scratch, less_than<float> p) {
+            return dispatch(first, last, scratch, FloatLessTest{p});
+        }
+
+        std::size_t stable_partition(float* first, float* last, float* scratch, in_range<float> p) {
+            return dispatch(first, last, scratch, FloatRangeTest{p});
+        }
+
+#else
+
+        std::size_t stable_partition(int* first, int* last, int* scratch, is_even p) {
+            return partition_scalar(first, last, scratch, 0, 0, p);
+        }
+
+        std::size_t stable_partition(int* first, int* last, int* scratch, less_than<int> p) {
+            return partition_scalar(first, last, scratch, 0, 0, p);
+        }
+
+        std::size_t stable_partition(int* first, int* last, int* scratch, in_range<int> p) {
+            return partition_scalar(first, last, scratch, 0, 0, p);
+        }
+
+        std::size_t stable_partition(float* first, float* last, float* scratch, less_than<float> p) {
+            return partition_scalar(first, last, scratch, 0, 0, p);
+        }
+
+        std::size_t stable_partition(float* first, float* last, float* scratch, in_range<float> p) {
+            return partition_scalar(first, last, scratch, 0, 0, p);
+        }
+
+#endif  // TND004_SIMD_X86
+
+    }  // namespace simd
+}  // namespace TND004
@@ -0,0 +1,101 @@
+// simd_partition.h : vectorized stable partition kernels for arithmetic predicates
+// AVX-512 (compress-store) and AVX2 (permutation table) kernels, selected at run time,
+// with a scalar fallback on other CPUs and compilers
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace TND004 {
+
+    /* **************************************************** *
+     * Predicates recognised by the vectorized kernels      *
+     * Other callables are evaluated one item at a time     *
+     * **************************************************** */
+
+    // i % 2 == 0
+    struct is_even {
+        bool operator()(int i) const {
+            return i % 2 == 0;
+        }
+    };
+
+    // x < pivot
+    template <typename T>
+    struct less_than {
+        T pivot;
+
+        bool operator()(T x) const {
+            return x < pivot;
+        }
+    };
+
+    // lo <= x <= hi
+    template <typename T>
+    struct in_range {
+        T lo;
+        T hi;
+
+        bool operator()(T x) const {
+            return lo <= x && x <= hi;
+        }
+    };
+
+    namespace simd {
+
+        // Instruction sets with a partition kernel, in increasing order of preference
+        enum class isa { scalar, avx2, avx512 };
+
+        // Return the best instruction set supported by the CPU (and by the compiler)
+        isa detected_isa();
+
+        // Return the instruction set used by the kernels
+        isa current_isa();
+
+        /** Select the instruction set used by the kernels
+         *
+         * Used for testing: requests above detected_isa() are lowered to detected_isa()
+         */
+        void set_isa(isa i);
+
+        /** Partition kernels
+         *
+         * Stable-partition [first, last) in place, the items not satisfying p are
+         * collected in scratch before being copied back after the even block
+         * \param scratch buffer with room for at least last-first items
+         * Return the number of items satisfying p
+         */
+        std::size_t stable_partition(int* first, int* last, int* scratch, is_even p);
+        std::size_t stable_partition(int* first, int* last, int* scratch, less_than<int> p);
+        std::size_t stable_partition(int* first, int* last, int* scratch, in_range<int> p);
+        std::size_t stable_partition(float* first, float* last, float* scratch, less_than<float> p);
+        std::size_t stable_partition(float* first, float* last, float* scratch, in_range<float> p);
+
+        // Is there a kernel for items of type T and predicate Pred?
+        template <typename T, typename Pred>
+        struct is_vectorizable : std::false_type {};
+
+        template <>
+        struct is_vectorizable<int, is_even> : std::true_type {};
+
+        template <>
+        struct is_vectorizable<int, less_than<int>> : std::true_type {};
+
+        template <>
+        struct is_vectorizable<int, in_range<int>> : std::true_type {};
+
+        template <>
+        struct is_vectorizable<float, less_than<float>> : std::true_type {};
+
+        template <>
+        struct is_vectorizable<float, in_range<float>> : std::true_type {};
+
+        // Is It a pointer, or a std::vector iterator, to contiguous items of type T?
+        template <typename It, typename T>
+        constexpr bool is_contiguous_v =
+            std::is_same_v<It, T*> || std::is_same_v<It, typename std::vector<T>::iterator>;
+
+    }  // namespace simd
+}  // namespace TND004
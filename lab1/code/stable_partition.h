@@ -0,0 +1,307 @@
+// stable_partition.h : generic stable partition algorithms
+// Templated on the iterator type and on the predicate, so that the predicate
+// call can be inlined by the compiler (no std::function dispatch per element)
+
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <type_traits>
+
+#include "partition_stats.h"
+#include "simd_partition.h"
+
+namespace TND004 {
+
+    /** Scratch arena used by the iterative algorithm
+     *
+     * One buffer per thread and element type, reused across calls such that
+     * no allocations are needed once the arena has grown to the largest uneven block
+     * (to the largest sequence, for the sequences partitioned by the vectorized kernels)
+     * Note: the arena keeps its capacity until release_scratch_arena is called
+     */
+    template <typename T>
+    std::vector<T>& scratch_arena() {
+        thread_local std::vector<T> arena;
+        return arena;
+    }
+
+    // Free the memory held by the calling thread's scratch arena for type T
+    template <typename T>
+    void release_scratch_arena() {
+        std::vector<T>{}.swap(scratch_arena<T>());
+    }
+
+    /** Iterative algorithm
+     *
+     * Stable-partition the sequence [first, last) such that all items satisfying p
+     * come before the items not satisfying p
+     * Items satisfying p are compacted in place, only the other items are moved to scratch
+     * and then moved back after the even block
+     * Items are only moved, never copied: no allocations for types with a noexcept move,
+     * once scratch has grown to the size of the largest uneven block
+     * Contiguous int and float sequences with a predicate recognised by simd_partition.h
+     * are partitioned by the vectorized kernels: these store the uneven items through a pointer,
+     * before their number is known, so scratch grows to the size of the whole sequence instead
+     * (zero-filled when it grows)
+     * \param first, last forward iterators to the sequence
+     * \param p unary predicate, any callable type
+     * \param scratch caller-supplied buffer, its contents are unspecified after the call
+     * but its capacity is reused
+     * Return an iterator to the first item not satisfying p
+     */
+    template <typename ForwardIt, typename Pred>
+    ForwardIt stable_partition_iterative(
+        ForwardIt first, ForwardIt last, Pred p,
+        std::vector<typename std::iterator_traits<ForwardIt>::value_type>& scratch) {
+        using T = typename std::iterator_traits<ForwardIt>::value_type;
+
+        if constexpr (simd::is_vectorizable<T, std::decay_t<Pred>>::value &&
+                      simd::is_contiguous_v<ForwardIt, T>) {
+            const auto n = static_cast<std::size_t>(last - first);
+            if (n == 0) {
+                return first;
+            }
+
+            // the kernels write to the scratch buffer through a pointer: it must have room for n items,
+            // all of them may be uneven; it only grows so that the zero-filling happens once per growth
+            if (scratch.size() < n) {
+                TND004_STATS(const std::size_t capacity = scratch.capacity());
+                scratch.resize(n);
+                TND004_STATS(if (scratch.capacity() != capacity) partition_stats().bytes_allocated +=
+                             scratch.capacity() * sizeof(T));
+            }
+
+            T* data = &*first;
+            const std::size_t even = simd::stable_partition(data, data + n, scratch.data(), p);
+
+            // the kernels store every item once, and the uneven items once more when they are moved back
+            TND004_STATS(partition_stats().predicate_calls += n);
+            TND004_STATS(partition_stats().moves += 2 * n - even);
+            return first + even;
+        }
+
+        TND004_STATS(PartitionStats& stats = partition_stats());
+        scratch.clear();
+
+        ForwardIt out = first;  // end of the even block
+        for (ForwardIt it = first; it != last; ++it) {
+            TND004_STATS(++stats.predicate_calls);
+            if (p(*it)) {
+                if (out != it) {
+                    *out = std::move(*it);
+                    TND004_STATS(++stats.moves);
+                }
+                ++out;
+            } else {
+                TND004_STATS(const std::size_t capacity = scratch.capacity());
+                scratch.push_back(std::move(*it));
+                TND004_STATS(++stats.moves);
+                TND004_STATS(if (scratch.capacity() != capacity) stats.bytes_allocated += scratch.capacity() * sizeof(T));
+            }
+        }
+
+        std::move(scratch.begin(), scratch.end(), out);
+        TND004_STATS(stats.moves += scratch.size());
+        scratch.clear();  // destroy the moved-from items, keep the capacity
+        return out;
+    }
+
+    // Iterative algorithm using the thread-local scratch arena
+    template <typename ForwardIt, typename Pred>
+    ForwardIt stable_partition_iterative(ForwardIt first, ForwardIt last, Pred p) {
+        using T = typename std::iterator_traits<ForwardIt>::value_type;
+        return TND004::stable_partition_iterative(first, last, p, scratch_arena<T>());
+    }
+
+    /** Divide-and-conquer algorithm
+     *
+     * Stable-partition the sub-sequence starting at first and ending at last-1
+     * If there are items with property p then return an iterator to the end of the block
+     * containing the items with property p. If there are no items with property p then return first.
+     * \param first, last forward iterators to the sequence (std::rotate requires forward iterators)
+     * \param p unary predicate, any callable type
+     */
+    template <typename ForwardIt, typename Pred>
+    ForwardIt stable_partition(ForwardIt first, ForwardIt last, Pred p) {
+        TND004_STATS(detail::DepthGuard depth);
+        const auto n = std::distance(first, last);
+
+        // Base Case 0 and 1: empty sequence or one element
+        if (n == 0) {
+            return first;
+        }
+        if (n == 1) {
+            TND004_STATS(++partition_stats().predicate_calls);
+            return p(*first) ? last : first;
+        }
+
+        // split the sequence into two halves, partition each of them
+        // and then swap the uneven block of the left half with the even block of the right half
+        // (std::rotate only swaps items, i.e. moves them)
+        ForwardIt mid = std::next(first, n / 2);
+
+        // explicit template arguments: Pred may be a reference type, and the predicate should not be copied
+        ForwardIt it1 = TND004::stable_partition<ForwardIt, Pred>(first, mid, p);
+        ForwardIt it3 = TND004::stable_partition<ForwardIt, Pred>(mid, last, p);
+
+        TND004_STATS(++partition_stats().rotations);
+        TND004_STATS(if (it1 != mid && mid != it3) {
+            const auto length = static_cast<std::size_t>(std::distance(it1, it3));
+            partition_stats().rotated_items += length;
+            partition_stats().moves += length;
+        });
+        return std::rotate(it1, mid, it3);
+    }
+
+    /** Bottom-up divide-and-conquer algorithm
+     *
+     * Non-recursive version of the divide-and-conquer algorithm
+     * 1. the sequence is cut in leaf blocks of leaf_bytes, which are partitioned with
+     *    the iterative algorithm (the scratch arena stays in the L1 cache)
+     * 2. neighbouring partitioned blocks are merged pairwise, level by level, by rotating
+     *    the uneven block of the left one with the even block of the right one
+     * There are no recursive calls and no rotations of blocks smaller than a leaf
+     * \param leaf_bytes size of the leaf blocks, in bytes (at least one item)
+     * Return an iterator to the first item not satisfying p
+     */
+    template <typename ForwardIt, typename Pred>
+    ForwardIt stable_partition_bottom_up(ForwardIt first, ForwardIt last, Pred p, std::size_t leaf_bytes = 4096) {
+        using T = typename std::iterator_traits<ForwardIt>::value_type;
+
+        // partitioned block [begin, next block begin), the even items are [begin, split)
+        struct Block {
+            ForwardIt begin;
+            ForwardIt split;
+        };
+
+        const std::size_t leaf = std::max<std::size_t>(1, leaf_bytes / sizeof(T));
+        std::vector<T>& scratch = scratch_arena<T>();
+
+        // Step 1: partition the leaf blocks
+        std::vector<Block> blocks;
+        for (ForwardIt it = first; it != last;) {
+            ForwardIt begin = it;
+            for (std::size_t i = 0; i < leaf && it != last; ++i) {
+                ++it;
+            }
+            blocks.push_back(Block{begin, TND004::stable_partition_iterative(begin, it, p, scratch)});
+        }
+
+        if (blocks.empty()) {
+            return first;
+        }
+
+        // Step 2: merge pairs of neighbouring blocks until one block is left
+        while (blocks.size() > 1) {
+            std::size_t merged = 0;
+
+            for (std::size_t i = 0; i < blocks.size(); i += 2) {
+                if (i + 1 == blocks.size()) {  // odd number of blocks: the last one moves up a level
+                    blocks[merged++] = blocks[i];
+                    break;
+                }
+
+                const Block& left = blocks[i];
+                const Block& right = blocks[i + 1];
+                blocks[merged++] = Block{left.begin, std::rotate(left.split, right.begin, right.split)};
+            }
+
+            blocks.resize(merged);
+        }
+
+        return blocks.front().split;
+    }
+
+    namespace detail {
+
+        /** Rotate [first, last) such that middle becomes the first item
+         *
+         * If one of the blocks fits in buffer then it is moved through buffer (one pass),
+         * otherwise std::rotate is used
+         */
+        template <typename ForwardIt, typename T>
+        ForwardIt rotate_adaptive(ForwardIt first, ForwardIt middle, ForwardIt last, std::size_t len1,
+                                  std::size_t len2, std::vector<T>& buffer, std::size_t capacity) {
+            using category = typename std::iterator_traits<ForwardIt>::iterator_category;
+
+            if (len1 == 0) {
+                return last;
+            }
+            if (len2 == 0) {
+                return first;
+            }
+
+            if (len1 <= capacity && len1 <= len2) {
+                buffer.clear();
+                std::move(first, middle, std::back_inserter(buffer));
+                ForwardIt result = std::move(middle, last, first);
+                std::move(buffer.begin(), buffer.end(), result);
+                return result;
+            }
+
+            if constexpr (std::is_base_of_v<std::bidirectional_iterator_tag, category>) {
+                if (len2 <= capacity) {
+                    buffer.clear();
+                    std::move(middle, last, std::back_inserter(buffer));
+                    std::move_backward(first, middle, last);
+                    return std::move(buffer.begin(), buffer.end(), first);
+                }
+            }
+
+            return std::rotate(first, middle, last);
+        }
+
+        template <typename ForwardIt, typename Pred, typename T>
+        ForwardIt stable_partition_adaptive(ForwardIt first, ForwardIt last, std::size_t n, Pred p,
+                                            std::vector<T>& buffer, std::size_t capacity) {
+            // the block fits in the buffer: linear buffered algorithm
+            if (n <= capacity) {
+                return TND004::stable_partition_iterative(first, last, p, buffer);
+            }
+
+            if (n == 1) {  // only possible if capacity == 0
+                return p(*first) ? last : first;
+            }
+
+            const std::size_t n1 = n / 2;
+            ForwardIt mid = std::next(first, n1);
+
+            ForwardIt it1 = detail::stable_partition_adaptive<ForwardIt, Pred>(first, mid, n1, p, buffer, capacity);
+            ForwardIt it3 = detail::stable_partition_adaptive<ForwardIt, Pred>(mid, last, n - n1, p, buffer, capacity);
+
+            return detail::rotate_adaptive(it1, mid, it3, static_cast<std::size_t>(std::distance(it1, mid)),
+                                           static_cast<std::size_t>(std::distance(mid, it3)), buffer, capacity);
+        }
+
+    }  // namespace detail
+
+    /** Adaptive algorithm with bounded extra memory
+     *
+     * At most budget_bytes of extra memory are allocated, for one buffer
+     * If the buffer can hold the whole sequence then the linear iterative algorithm is used,
+     * otherwise the sequence is split as in the divide-and-conquer algorithm until the blocks
+     * fit in the buffer, i.e. only the top log(N / buffer size) levels are merged by rotations,
+     * and rotations of blocks that fit in the buffer are done in one pass
+     * \param budget_bytes maximum number of bytes allocated (0 means no buffer at all)
+     * Return an iterator to the first item not satisfying p
+     */
+    template <typename ForwardIt, typename Pred>
+    ForwardIt stable_partition_adaptive(ForwardIt first, ForwardIt last, Pred p, std::size_t budget_bytes) {
+        using T = typename std::iterator_traits<ForwardIt>::value_type;
+
+        const auto n = static_cast<std::size_t>(std::distance(first, last));
+        if (n == 0) {
+            return first;
+        }
+
+        const std::size_t capacity = std::min(n, budget_bytes / sizeof(T));
+
+        std::vector<T> buffer;
+        buffer.reserve(capacity);
+
+        return detail::stable_partition_adaptive<ForwardIt, Pred>(first, last, n, p, buffer, capacity);
+    }
+
+}  // namespace TND004
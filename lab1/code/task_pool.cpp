@@ -0,0 +1,137 @@
+#include "task_pool.h"
+
+namespace TND004 {
+
+    namespace {
+        // Pool and deque index of the calling thread, if it is a worker thread
+        thread_local const TaskPool* current_pool = nullptr;
+        thread_local std::size_t current_index = 0;
+    }  // namespace
+
+    TaskPool::TaskPool(unsigned threads) {
+        if (threads == 0) {  // hardware_concurrency may be unknown
+            threads = 1;
+        }
+
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+        }
+
+        // workers_[0] belongs to the external threads
+        for (unsigned i = 1; i < threads; ++i) {
+            threads_.emplace_back([this, i] { worker_loop(i); });
+        }
+    }
+
+    TaskPool::~TaskPool() {
+        {
+            std::lock_guard<std::mutex> guard{sleep_lock_};
+            stop_ = true;
+        }
+        wake_up_.notify_all();
+
+        for (std::thread& t : threads_) {
+            t.join();
+        }
+    }
+
+    TaskPool& default_pool() {
+        static TaskPool pool;
+        return pool;
+    }
+
+    /* ******************************************** *
+     * Private Member Functions -- Implementation   *
+     * ******************************************** */
+
+    TaskPool::Worker& TaskPool::local() {
+        if (current_pool == this) {
+            return *workers_[current_index];
+        }
+        return *workers_[0];
+    }
+
+    void TaskPool::push(Worker& w, Task* t) {
+        {
+            std::lock_guard<std::mutex> guard{w.lock};
+            w.tasks.push_back(t);
+            ++pending_;
+        }
+
+        // taking the lock avoids a lost wake-up between the test and the wait in worker_loop
+        { std::lock_guard<std::mutex> guard{sleep_lock_}; }
+        wake_up_.notify_one();
+    }
+
+    bool TaskPool::try_take(Worker& w, Task* t) {
+        std::lock_guard<std::mutex> guard{w.lock};
+
+        if (!w.tasks.empty() && w.tasks.back() == t) {
+            w.tasks.pop_back();
+            --pending_;
+            return true;
+        }
+        return false;
+    }
+
+    TaskPool::Task* TaskPool::find_work(Worker& w) {
+        {  // newest task of the own deque first
+            std::lock_guard<std::mutex> guard{w.lock};
+
+            if (!w.tasks.empty()) {
+                Task* t = w.tasks.back();
+                w.tasks.pop_back();
+                --pending_;
+                return t;
+            }
+        }
+
+        // steal the oldest task of another deque, i.e. the largest piece of work
+        for (auto& victim : workers_) {
+            if (victim.get() == &w) {
+                continue;
+            }
+
+            std::lock_guard<std::mutex> guard{victim->lock};
+
+            if (!victim->tasks.empty()) {
+                Task* t = victim->tasks.front();
+                victim->tasks.pop_front();
+                --pending_;
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    void TaskPool::wait_for(Worker& w, Task& t) {
+        while (!t.done.load(std::memory_order_acquire)) {
+            if (Task* other = find_work(w)) {
+                other->run();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void TaskPool::worker_loop(std::size_t index) {
+        current_pool = this;
+        current_index = index;
+        Worker& w = *workers_[index];
+
+        while (true) {
+            if (Task* t = find_work(w)) {
+                t->run();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard{sleep_lock_};
+            wake_up_.wait(guard, [this] { return stop_ || pending_ > 0; });
+
+            if (stop_) {
+                return;
+            }
+        }
+    }
+
+}  // namespace TND004
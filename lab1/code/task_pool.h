@@ -0,0 +1,162 @@
+// task_pool.h : small work-stealing task pool for fork-join parallelism
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TND004 {
+
+    /** Class to represent a pool of worker threads
+     *
+     * Every worker owns a deque of tasks: the owner pushes and pops at the back,
+     * idle workers steal from the front of the other deques
+     * Threads that do not belong to the pool (e.g. main) share one extra deque
+     * A thread waiting for a forked task keeps executing other tasks meanwhile,
+     * so nested fork-join calls cannot deadlock
+     */
+    class TaskPool {
+    public:
+        /** Constructor
+         *
+         * \param threads total number of threads taking part in the computations,
+         * including the calling thread, i.e. threads-1 background workers are started
+         */
+        explicit TaskPool(unsigned threads = std::thread::hardware_concurrency());
+
+        // Destructor: stop and join all workers
+        ~TaskPool();
+
+        TaskPool(const TaskPool&) = delete;
+        TaskPool& operator=(const TaskPool&) = delete;
+
+        // Return number of threads taking part in the computations
+        unsigned size() const {
+            return static_cast<unsigned>(workers_.size());
+        }
+
+        /** Execute f1() and f2(), possibly in parallel
+         *
+         * f2 is made available for stealing while the calling thread executes f1
+         * Return when both calls have finished
+         * If any of the calls throws then the exception is rethrown here
+         */
+        template <typename F1, typename F2>
+        void invoke(F1&& f1, F2&& f2);
+
+    private:
+        // Task forked by invoke, stored in the stack frame of invoke
+        struct Task {
+            virtual void run() = 0;
+
+            std::atomic<bool> done{false};
+            std::exception_ptr error;
+
+        protected:
+            ~Task() = default;
+        };
+
+        template <typename F>
+        struct CallTask final : Task {
+            explicit CallTask(F& f) : fn{f} {
+            }
+
+            void run() override {
+                try {
+                    fn();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                done.store(true, std::memory_order_release);
+            }
+
+            F& fn;
+        };
+
+        struct Worker {
+            std::mutex lock;
+            std::deque<Task*> tasks;
+        };
+
+        // Return the deque of the calling thread
+        Worker& local();
+
+        void push(Worker& w, Task* t);
+        bool try_take(Worker& w, Task* t);  // remove t from the back of w, if it was not stolen
+        Task* find_work(Worker& w);         // pop from w, otherwise steal from other workers
+        void wait_for(Worker& w, Task& t);  // execute other tasks until t is done
+        void worker_loop(std::size_t index);
+
+        std::vector<std::unique_ptr<Worker>> workers_;  // workers_[0] is shared by external threads
+        std::vector<std::thread> threads_;
+
+        std::mutex sleep_lock_;
+        std::condition_variable wake_up_;
+        std::atomic<std::size_t> pending_{0};  // number of tasks waiting in the deques
+        bool stop_{false};
+    };
+
+    // Pool shared by the whole program, with one thread per hardware core
+    TaskPool& default_pool();
+
+    /** Execute f(i) for every i in [first, last), possibly in parallel
+     *
+     * The index range is split in halves with TaskPool::invoke until one index is left
+     */
+    template <typename F>
+    void parallel_for(TaskPool& pool, std::size_t first, std::size_t last, const F& f) {
+        if (last - first > 1) {
+            const std::size_t mid = first + (last - first) / 2;
+            pool.invoke([&] { parallel_for(pool, first, mid, f); }, [&] { parallel_for(pool, mid, last, f); });
+        } else if (first < last) {
+            f(first);
+        }
+    }
+
+    /* ******************************************** *
+     * Template member functions -- Implementation  *
+     * ******************************************** */
+
+    template <typename F1, typename F2>
+    void TaskPool::invoke(F1&& f1, F2&& f2) {
+        if (size() == 1) {
+            f1();
+            f2();
+            return;
+        }
+
+        Worker& w = local();
+        CallTask<std::remove_reference_t<F2>> task{f2};
+        push(w, &task);
+
+        try {
+            f1();
+        } catch (...) {
+            // task refers to the stack frame, it must finish before leaving
+            if (try_take(w, &task)) {
+                throw;
+            }
+            wait_for(w, task);
+            throw;
+        }
+
+        if (try_take(w, &task)) {
+            task.run();  // nobody stole it
+        } else {
+            wait_for(w, task);
+        }
+
+        if (task.error) {
+            std::rethrow_exception(task.error);
+        }
+    }
+
+}  // namespace TND004
@@ -0,0 +1,273 @@
+#include <algorithm>
+
+#include "flat_set.h"
+#include "simd_set.h"
+
+std::int64_t FlatSet::count_nodes = 0;  // initialize total number of "nodes" to zero
+
+namespace {
+
+    // The intersection and difference gallop when one FlatSet is at least gallop_ratio times larger
+    constexpr std::size_t gallop_ratio = 32;
+
+    bool use_gallop(std::size_t n, std::size_t m) {
+        return std::min(n, m) * gallop_ratio <= std::max(n, m);
+    }
+
+    /** Galloping (exponential) search
+     *
+     * Return the index of the first int >= x in a[first .. n), n if there is none
+     * The steps 1, 2, 4, ... from first bracket the position, which is then found by a binary search:
+     * O(log d) comparisons, where d is the distance from first
+     */
+    std::size_t gallop(const std::vector<int>& a, std::size_t first, int x) {
+        const std::size_t n = a.size();
+        std::size_t lo = first;  // a[lo - 1] < x, if lo > first
+        std::size_t step = 1;
+
+        while (first + step - 1 < n && a[first + step - 1] < x) {
+            lo = first + step;
+            step *= 2;
+        }
+        const std::size_t hi = std::min(n, first + step - 1);
+        return static_cast<std::size_t>(std::lower_bound(a.begin() + lo, a.begin() + hi, x) - a.begin());
+    }
+
+}  // namespace
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+// Used for debug purposes
+// Return number of "nodes" of the existing FlatSets  -- static member function
+std::int64_t FlatSet::get_count_nodes() {
+    return FlatSet::count_nodes;
+}
+
+// Default constructor
+FlatSet::FlatSet() {
+    count_nodes += 2;  // the dummy nodes of a Set
+}
+
+// Conversion constructor
+FlatSet::FlatSet(int n) : values{n} {
+    count_nodes += 3;
+}
+
+// Constructor to create a FlatSet from a sorted vector v
+FlatSet::FlatSet(const std::vector<int>& v) : values{v} {
+    count_nodes += 2 + static_cast<std::int64_t>(values.size());
+}
+
+// Copy constructor
+FlatSet::FlatSet(const FlatSet& source) : values{source.values} {
+    count_nodes += 2 + static_cast<std::int64_t>(values.size());
+}
+
+// Move constructor
+FlatSet::FlatSet(FlatSet&& source) noexcept {
+    count_nodes += 2;
+    values.swap(source.values);
+}
+
+FlatSet::~FlatSet() {
+    count_nodes -= 2 + static_cast<std::int64_t>(values.size());
+}
+
+// Copy-and-swap assignment operator
+// The number of "nodes" of *this and source are exchanged: no change in total
+FlatSet& FlatSet::operator=(FlatSet source) {
+    values.swap(source.values);
+    return *this;
+}
+
+// Test set membership, binary search
+bool FlatSet::is_member(int val) const {
+    return std::binary_search(values.begin(), values.end(), val);
+}
+
+// Test whether a set is empty
+bool FlatSet::is_empty() const {
+    return values.empty();
+}
+
+// Return number of elements in the set
+size_t FlatSet::cardinality() const {
+    return values.size();
+}
+
+// Make the set empty
+void FlatSet::make_empty() {
+    const std::size_t old_size = values.size();
+    values.clear();
+    _resized(old_size);
+}
+
+// Modify *this such that it becomes the union of *this with FlatSet S
+// The ints of S not in *this are found with the vectorized difference kernel (simd_set.h),
+// then the two disjoint sorted arrays are merged from the back, in place and without branches
+FlatSet& FlatSet::operator+=(const FlatSet& S) {
+    if (&S == this) {
+        return *this;
+    }
+
+    const std::size_t n = values.size();
+    const std::size_t m = S.values.size();
+
+    // ints of S not in *this, a local buffer: values may be reallocated on this path anyway
+    std::vector<int> extra(m);
+    const std::size_t d = simd::difference(S.values.data(), m, values.data(), n, extra.data());
+
+    if (d == 0) {  // S is a subset of *this
+        return *this;
+    }
+
+    values.resize(n + d);
+
+    std::size_t i = n;  // number of ints of *this left to merge
+    std::size_t j = d;  // number of ints of extra left to merge
+    std::size_t out = n + d;
+
+    while (i > 0 && j > 0) {
+        const int x = values[i - 1];
+        const int y = extra[j - 1];
+        const bool take_x = x > y;
+        values[--out] = take_x ? x : y;
+        i -= take_x;
+        j -= !take_x;
+    }
+    while (j > 0) {
+        values[--out] = extra[--j];
+    }
+    // the remaining ints of *this, values[0 .. i), are already in place
+
+    _resized(n);
+    return *this;
+}
+
+// Modify *this such that it becomes the intersection of *this with FlatSet S
+// Vectorized kernel (simd_set.h) if the sizes are similar, otherwise every int of the smallest
+// FlatSet is searched in the largest one by galloping: O(m log(n/m)) comparisons
+// The ints kept are compacted in place
+FlatSet& FlatSet::operator*=(const FlatSet& S) {
+    if (&S == this) {
+        return *this;
+    }
+
+    const std::size_t n = values.size();
+    const std::size_t m = S.values.size();
+
+    if (!use_gallop(n, m)) {
+        values.resize(simd::intersection(values.data(), n, S.values.data(), m, values.data()));
+    } else if (n < m) {  // look for every int of *this in S
+        std::size_t out = 0;
+        std::size_t j = 0;
+        for (std::size_t i = 0; i < n && j < m; ++i) {
+            j = gallop(S.values, j, values[i]);
+            if (j < m && S.values[j] == values[i]) {
+                values[out++] = values[i];
+            }
+        }
+        values.resize(out);
+    } else {  // look for every int of S in *this
+        std::size_t out = 0;
+        std::size_t i = 0;
+        for (std::size_t j = 0; j < m && i < n; ++j) {
+            i = gallop(values, i, S.values[j]);
+            if (i < n && values[i] == S.values[j]) {
+                values[out++] = values[i];
+            }
+        }
+        values.resize(out);
+    }
+
+    _resized(n);
+    return *this;
+}
+
+// Modify *this such that it becomes the FlatSet difference between *this and FlatSet S
+// Vectorized kernel (simd_set.h) if the sizes are similar, otherwise every int of the smallest
+// FlatSet is searched in the largest one by galloping: O(m log(n/m)) comparisons
+// The ints kept are compacted in place
+FlatSet& FlatSet::operator-=(const FlatSet& S) {
+    const std::size_t n = values.size();
+    const std::size_t m = S.values.size();
+
+    if (&S == this) {
+        values.clear();
+    } else if (!use_gallop(n, m)) {
+        values.resize(simd::difference(values.data(), n, S.values.data(), m, values.data()));
+    } else if (n < m) {  // look for every int of *this in S
+        std::size_t out = 0;
+        std::size_t j = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            j = gallop(S.values, j, values[i]);
+            if (j == m || S.values[j] != values[i]) {
+                values[out++] = values[i];
+            }
+        }
+        values.resize(out);
+    } else {  // look for every int of S in *this, the runs between them are moved down
+        std::size_t out = 0;
+        std::size_t i = 0;
+        for (std::size_t j = 0; j < m && i < n; ++j) {
+            const std::size_t pos = gallop(values, i, S.values[j]);
+            if (pos < n && values[pos] == S.values[j]) {
+                out = static_cast<std::size_t>(
+                    std::move(values.begin() + i, values.begin() + pos, values.begin() + out) - values.begin());
+                i = pos + 1;
+            }
+        }
+        out = static_cast<std::size_t>(std::move(values.begin() + i, values.end(), values.begin() + out) -
+                                       values.begin());
+        values.resize(out);
+    }
+
+    _resized(n);
+    return *this;
+}
+
+// Overloaded stream insertion operator<<
+std::ostream& operator<<(std::ostream& os, const FlatSet& b) {
+    if (b.is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (int x : b.values) {
+            os << x << " ";
+        }
+        os << "}";
+    }
+    return os;
+}
+
+// Overloaded subset operator<=
+bool operator<=(const FlatSet& S1, const FlatSet& S2) {
+    return S1.cardinality() <= S2.cardinality() &&
+           std::includes(S2.values.begin(), S2.values.end(), S1.values.begin(), S1.values.end());
+}
+
+// Overloaded proper subset operator<
+bool operator<(const FlatSet& S1, const FlatSet& S2) {
+    return S1.cardinality() < S2.cardinality() && S1 <= S2;
+}
+
+// Overloaded equality operator==
+bool operator==(const FlatSet& S1, const FlatSet& S2) {
+    return S1.values == S2.values;
+}
+
+// Overloaded not equal operator!=
+bool operator!=(const FlatSet& S1, const FlatSet& S2) {
+    return !(S1 == S2);
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+// Update count_nodes after the number of values changed from old_size
+void FlatSet::_resized(std::size_t old_size) {
+    count_nodes += static_cast<std::int64_t>(values.size()) - static_cast<std::int64_t>(old_size);
+}
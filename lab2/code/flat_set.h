@@ -0,0 +1,208 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/** Class to represent a Set of ints, stored in a sorted vector
+ *
+ * FlatSet has the same interface as Set (set.h), but the ints are stored contiguously,
+ * such that the union, intersection, difference and subset tests are sequential passes
+ * over arrays instead of pointer chasing
+ * FlatSets should not contain repetitions, i.e.
+ * two ints with the same value cannot belong to a FlatSet
+ *
+ * All FlatSet operations have a linear complexity, in the worst case
+ * is_member is a binary search
+ * The union, intersection and difference use the vectorized kernels of simd_set.h
+ * When one FlatSet is much larger than the other, the intersection and difference search the ints
+ * of the smallest one in the largest one by galloping: O(m log(n/m)), with m <= n the cardinalities
+ */
+class FlatSet {
+public:
+    // Default constructor: create an empty FlatSet
+    FlatSet();
+
+    // Conversion constructor: convert val into a singleton {val}
+    FlatSet(int val);
+
+    /** Constructor to create a FlatSet from a sorted vector of ints
+     *
+     * Create a FlatSet with all ints in sorted vector v
+     * \param v sorted vector of ints
+     *
+     */
+    FlatSet(const std::vector<int>& v);
+
+    /** Copy constructor
+     *
+     * Create a new FlatSet as a copy of FlatSet b
+     * \param b FlatSet to be copied
+     * Function does not modify FlatSet b in any way
+     *
+     */
+    FlatSet(const FlatSet& b);
+
+    /** Move constructor
+     *
+     * Create a new FlatSet with the ints of FlatSet b, which becomes empty
+     *
+     */
+    FlatSet(FlatSet&& b) noexcept;
+
+    // Destructor
+    ~FlatSet();
+
+    /** Assignment operator
+     *
+     * Assigns new contents to the FlatSet, replacing its current content
+     * \param source FlatSet to be copied (or moved) into FlatSet *this
+     *
+     */
+    FlatSet& operator=(FlatSet source);
+
+    /** Test whether val belongs to the FlatSet
+     *
+     * Return true if val belongs to the set, otherwise false
+     *
+     */
+    bool is_member(int val) const;
+
+    /** Test whether the FlatSet is empty
+     *
+     * Return true if the set is empty, otherwise false
+     *
+     */
+    bool is_empty() const;
+
+    /** Count the number of values stored in the FlatSet
+     *
+     * Return number of elements in the set
+     *
+     */
+    size_t cardinality() const;
+
+    // Transform the FlatSet into an empty set
+    void make_empty();
+
+    /** Modify FlatSet *this such that it becomes the union of *this with FlatSet S
+     *
+     * FlatSet *this is modified and then returned
+     *
+     */
+    FlatSet& operator+=(const FlatSet& S);
+
+    /** Modify FlatSet *this such that it becomes the intersection of *this with FlatSet S
+     *
+     * FlatSet *this is modified and then returned
+     *
+     */
+    FlatSet& operator*=(const FlatSet& S);
+
+    /** Modify FlatSet *this such that it becomes the Set difference between FlatSet *this and FlatSet S
+     *
+     * FlatSet *this is modified and then returned
+     *
+     */
+    FlatSet& operator-=(const FlatSet& S);
+
+    /** Return number of nodes a Set with the same values would have
+     *
+     * Every existing FlatSet counts as two dummy nodes plus one node per int, as Set does,
+     * so that the leak tests written for Set also hold for FlatSet
+     * 64-bit, as a FlatSet may hold more than INT_MAX ints
+     * Used for debug purposes
+     */
+    static std::int64_t get_count_nodes();
+
+private:
+    std::vector<int> values;  // sorted ints of the set
+
+    static std::int64_t count_nodes;  // total number of "nodes" of the existing FlatSets
+
+    // Update count_nodes after the number of values changed from old_size
+    void _resized(std::size_t old_size);
+
+    /* **************************** *
+     * Overloaded operators         *
+     * ***************************** */
+
+    // Overloaded operator<<, same format as for Set
+    friend std::ostream& operator<<(std::ostream& os, const FlatSet& b);
+
+    // Test whether FlatSet S1 is a subset of FlatSet S2
+    friend bool operator<=(const FlatSet& S1, const FlatSet& S2);
+
+    // Test whether FlatSet S1 and S2 represent the same set
+    friend bool operator==(const FlatSet& S1, const FlatSet& S2);
+
+    // Test whether FlatSet S1 and S2 represent different sets
+    friend bool operator!=(const FlatSet& S1, const FlatSet& S2);
+
+    // Test whether FlatSet S1 is a strict subset of FlatSet S2
+    friend bool operator<(const FlatSet& S1, const FlatSet& S2);
+
+    /** Overloaded operator+: Set union S1+S2
+     *
+     * S1 is copied, or moved if it is a temporary, and S2 is merged into it
+     *
+     */
+    friend FlatSet operator+(FlatSet S1, const FlatSet& S2) {
+        S1 += S2;
+        return S1;
+    }
+
+    // Union with a temporary S2: the storage of S2 is reused
+    friend FlatSet operator+(const FlatSet& S1, FlatSet&& S2) {
+        S2 += S1;
+        return std::move(S2);
+    }
+
+    // Union of two temporaries: the storage of the largest FlatSet is reused
+    friend FlatSet operator+(FlatSet&& S1, FlatSet&& S2) {
+        if (S1.cardinality() < S2.cardinality()) {
+            S2 += S1;
+            return std::move(S2);
+        }
+        S1 += S2;
+        return std::move(S1);
+    }
+
+    /** Overloaded operator*: Set intersection S1*S2
+     *
+     * S1 is copied, or moved if it is a temporary, and the ints not in S2 are removed
+     *
+     */
+    friend FlatSet operator*(FlatSet S1, const FlatSet& S2) {
+        S1 *= S2;
+        return S1;
+    }
+
+    // Intersection with a temporary S2: the storage of S2 is reused
+    friend FlatSet operator*(const FlatSet& S1, FlatSet&& S2) {
+        S2 *= S1;
+        return std::move(S2);
+    }
+
+    // Intersection of two temporaries: the storage of the smallest FlatSet is reused
+    friend FlatSet operator*(FlatSet&& S1, FlatSet&& S2) {
+        if (S2.cardinality() < S1.cardinality()) {
+            S2 *= S1;
+            return std::move(S2);
+        }
+        S1 *= S2;
+        return std::move(S1);
+    }
+
+    /** Overloaded operator-: Set difference S1-S2
+     *
+     * S1 is copied, or moved if it is a temporary
+     *
+     */
+    friend FlatSet operator-(FlatSet S1, const FlatSet& S2) {
+        S1 -= S2;
+        return S1;
+    }
+};
@@ -0,0 +1,279 @@
+#include <algorithm>
+
+#include "interval_set.h"
+
+std::int64_t IntervalSet::count_nodes = 0;  // initialize total number of "nodes" to zero
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+// Used for debug purposes
+// Return number of "nodes" of the existing IntervalSets  -- static member function
+std::int64_t IntervalSet::get_count_nodes() {
+    return IntervalSet::count_nodes;
+}
+
+// Default constructor
+IntervalSet::IntervalSet() {
+    count_nodes += 2;  // the dummy nodes of a Set
+}
+
+// Conversion constructor
+IntervalSet::IntervalSet(int n) : IntervalSet{n, n} {
+}
+
+// Constructor to create the IntervalSet [lo, hi]
+IntervalSet::IntervalSet(int lo, int hi) : IntervalSet{} {
+    if (lo <= hi) {
+        std::vector<Run> R;
+        std::uint64_t n = 0;
+        _append(R, n, lo, hi);
+        _assign(std::move(R), n);
+    }
+}
+
+// Constructor to create an IntervalSet from a sorted vector v
+IntervalSet::IntervalSet(const std::vector<int>& v) : IntervalSet{} {
+    std::vector<Run> R;
+    std::uint64_t n = 0;
+    for (int x : v) {
+        _append(R, n, x, x);
+    }
+    _assign(std::move(R), n);
+}
+
+// Constructor to create an IntervalSet from a Set
+IntervalSet::IntervalSet(const Set& S) : IntervalSet{S.to_vector()} {
+}
+
+// Copy constructor
+IntervalSet::IntervalSet(const IntervalSet& source) : intervals{source.intervals}, counter{source.counter} {
+    count_nodes += 2 + static_cast<std::int64_t>(counter);
+}
+
+// Move constructor
+IntervalSet::IntervalSet(IntervalSet&& source) noexcept {
+    count_nodes += 2;
+    intervals.swap(source.intervals);
+    std::swap(counter, source.counter);
+}
+
+IntervalSet::~IntervalSet() {
+    count_nodes -= 2 + static_cast<std::int64_t>(counter);
+}
+
+// Copy-and-swap assignment operator
+// The number of "nodes" of *this and source are exchanged: no change in total
+IntervalSet& IntervalSet::operator=(IntervalSet source) {
+    intervals.swap(source.intervals);
+    std::swap(counter, source.counter);
+    return *this;
+}
+
+// Test set membership: binary search for the last run starting at or before val
+bool IntervalSet::is_member(int val) const {
+    const auto it = std::upper_bound(intervals.begin(), intervals.end(), val,
+                                     [](int v, const Run& r) { return v < r.lo; });
+    return it != intervals.begin() && val <= (it - 1)->hi;
+}
+
+// Test whether a set is empty
+bool IntervalSet::is_empty() const {
+    return intervals.empty();
+}
+
+// Return number of elements in the set
+size_t IntervalSet::cardinality() const {
+    return static_cast<size_t>(counter);
+}
+
+// Return number of runs
+size_t IntervalSet::runs() const {
+    return intervals.size();
+}
+
+// Make the set empty
+void IntervalSet::make_empty() {
+    _assign({}, 0);
+}
+
+// Return the values of the set in increasing order
+std::vector<int> IntervalSet::to_vector() const {
+    std::vector<int> v;
+    v.reserve(cardinality());
+    for (const Run& r : intervals) {
+        for (std::int64_t x = r.lo; x <= r.hi; ++x) {
+            v.push_back(static_cast<int>(x));
+        }
+    }
+    return v;
+}
+
+// Return the set as a sorted doubly linked list
+Set IntervalSet::to_set() const {
+    return Set{to_vector()};
+}
+
+// Modify *this such that it becomes the union of *this with IntervalSet S
+// The runs of both sets are merged in order of lo, overlapping and adjacent runs are joined
+IntervalSet& IntervalSet::operator+=(const IntervalSet& S) {
+    if (&S == this) {
+        return *this;
+    }
+
+    std::vector<Run> R;
+    R.reserve(intervals.size() + S.intervals.size());
+    std::uint64_t n = 0;
+
+    auto i = intervals.begin();
+    auto j = S.intervals.begin();
+    while (i != intervals.end() || j != S.intervals.end()) {
+        const bool take_i = (j == S.intervals.end()) || (i != intervals.end() && i->lo < j->lo);
+        const Run& r = take_i ? *i++ : *j++;
+        _append(R, n, r.lo, r.hi);
+    }
+
+    _assign(std::move(R), n);
+    return *this;
+}
+
+// Modify *this such that it becomes the intersection of *this with IntervalSet S
+// Every pair of overlapping runs gives one run, the run ending first is then passed
+IntervalSet& IntervalSet::operator*=(const IntervalSet& S) {
+    if (&S == this) {
+        return *this;
+    }
+
+    std::vector<Run> R;
+    std::uint64_t n = 0;
+
+    auto i = intervals.begin();
+    auto j = S.intervals.begin();
+    while (i != intervals.end() && j != S.intervals.end()) {
+        const int lo = std::max(i->lo, j->lo);
+        const int hi = std::min(i->hi, j->hi);
+        if (lo <= hi) {
+            _append(R, n, lo, hi);
+        }
+        if (i->hi < j->hi) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+
+    _assign(std::move(R), n);
+    return *this;
+}
+
+// Modify *this such that it becomes the IntervalSet difference between *this and IntervalSet S
+// The runs of S overlapping a run of *this are cut out of it, from left to right
+IntervalSet& IntervalSet::operator-=(const IntervalSet& S) {
+    if (&S == this) {
+        make_empty();
+        return *this;
+    }
+
+    std::vector<Run> R;
+    std::uint64_t n = 0;
+
+    auto j = S.intervals.begin();
+    for (const Run& r : intervals) {
+        std::int64_t lo = r.lo;  // first int of r not cut yet
+
+        // skip the runs of S ending before r
+        while (j != S.intervals.end() && j->hi < r.lo) {
+            ++j;
+        }
+        // a run of S overlapping the end of r may also overlap the next run of *this: j is not passed
+        for (auto k = j; k != S.intervals.end() && k->lo <= r.hi && lo <= r.hi; ++k) {
+            if (k->lo > lo) {
+                _append(R, n, lo, std::int64_t{k->lo} - 1);
+            }
+            lo = std::int64_t{k->hi} + 1;
+        }
+        if (lo <= r.hi) {
+            _append(R, n, lo, r.hi);
+        }
+    }
+
+    _assign(std::move(R), n);
+    return *this;
+}
+
+// Overloaded stream insertion operator<<
+std::ostream& operator<<(std::ostream& os, const IntervalSet& b) {
+    if (b.is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (const IntervalSet::Run& r : b.intervals) {
+            for (std::int64_t x = r.lo; x <= r.hi; ++x) {
+                os << x << " ";
+            }
+        }
+        os << "}";
+    }
+    return os;
+}
+
+// Overloaded subset operator<=
+// Every run of S1 must be inside a run of S2, the runs of S2 are visited once
+bool operator<=(const IntervalSet& S1, const IntervalSet& S2) {
+    if (S1.counter > S2.counter) {
+        return false;
+    }
+
+    auto j = S2.intervals.begin();
+    for (const IntervalSet::Run& r : S1.intervals) {
+        while (j != S2.intervals.end() && j->hi < r.lo) {
+            ++j;
+        }
+        if (j == S2.intervals.end() || j->lo > r.lo || j->hi < r.hi) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Overloaded proper subset operator<
+bool operator<(const IntervalSet& S1, const IntervalSet& S2) {
+    return S1.counter < S2.counter && S1 <= S2;
+}
+
+// Overloaded equality operator==
+// The runs are maximal: equal sets have the same runs
+bool operator==(const IntervalSet& S1, const IntervalSet& S2) {
+    return S1.counter == S2.counter && S1.intervals == S2.intervals;
+}
+
+// Overloaded not equal operator!=
+bool operator!=(const IntervalSet& S1, const IntervalSet& S2) {
+    return !(S1 == S2);
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+// Append run [lo, hi] to R, 64-bit such that hi + 1 and the length of the run do not overflow
+void IntervalSet::_append(std::vector<Run>& R, std::uint64_t& n, std::int64_t lo, std::int64_t hi) {
+    if (!R.empty() && lo <= std::int64_t{R.back().hi} + 1) {  // overlapping or adjacent
+        if (hi > R.back().hi) {
+            n += static_cast<std::uint64_t>(hi - R.back().hi);
+            R.back().hi = static_cast<int>(hi);
+        }
+        return;
+    }
+
+    R.push_back({static_cast<int>(lo), static_cast<int>(hi)});
+    n += static_cast<std::uint64_t>(hi - lo + 1);
+}
+
+// Replace the runs with R, holding n ints
+void IntervalSet::_assign(std::vector<Run>&& R, std::uint64_t n) {
+    count_nodes += static_cast<std::int64_t>(n) - static_cast<std::int64_t>(counter);
+    intervals.swap(R);
+    counter = n;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "set.h"
+
+/** Class to represent a Set of ints, stored as sorted disjoint runs [lo, hi] of consecutive ints
+ *
+ * IntervalSet has the same interface as Set (set.h), but a range of ints such as
+ * {1..100000} takes one run instead of one Node per int
+ * The runs are maximal: two runs are neither overlapping nor adjacent, so that
+ * every set has exactly one representation
+ *
+ * The union, intersection, difference and subset tests are merges of the runs:
+ * linear in the number of runs, whatever the number of ints in them
+ * The cardinality is updated by every operation, from the runs it writes: O(1)
+ * is_member is a binary search over the runs
+ * The lengths of the runs and the cardinality are computed with 64-bit ints:
+ * a run may hold all 2^32 ints
+ */
+class IntervalSet {
+public:
+    // Default constructor: create an empty IntervalSet
+    IntervalSet();
+
+    // Conversion constructor: convert val into a singleton {val}
+    IntervalSet(int val);
+
+    // Constructor to create the IntervalSet {lo, lo + 1, ..., hi}, empty if hi < lo
+    IntervalSet(int lo, int hi);
+
+    /** Constructor to create an IntervalSet from a sorted vector of ints
+     *
+     * Create an IntervalSet with all ints in sorted vector v
+     * Consecutive ints of v are stored in the same run
+     * \param v sorted vector of ints
+     *
+     */
+    IntervalSet(const std::vector<int>& v);
+
+    /** Constructor to create an IntervalSet from a Set
+     *
+     * Create an IntervalSet with all ints in Set S
+     *
+     */
+    explicit IntervalSet(const Set& S);
+
+    /** Copy constructor
+     *
+     * Create a new IntervalSet as a copy of IntervalSet b
+     * \param b IntervalSet to be copied
+     * Function does not modify IntervalSet b in any way
+     *
+     */
+    IntervalSet(const IntervalSet& b);
+
+    /** Move constructor
+     *
+     * Create a new IntervalSet with the runs of IntervalSet b, which becomes empty
+     *
+     */
+    IntervalSet(IntervalSet&& b) noexcept;
+
+    // Destructor
+    ~IntervalSet();
+
+    /** Assignment operator
+     *
+     * Assigns new contents to the IntervalSet, replacing its current content
+     * \param source IntervalSet to be copied (or moved) into IntervalSet *this
+     *
+     */
+    IntervalSet& operator=(IntervalSet source);
+
+    /** Test whether val belongs to the IntervalSet
+     *
+     * Return true if val belongs to the set, otherwise false
+     *
+     */
+    bool is_member(int val) const;
+
+    /** Test whether the IntervalSet is empty
+     *
+     * Return true if the set is empty, otherwise false
+     *
+     */
+    bool is_empty() const;
+
+    /** Count the number of values stored in the IntervalSet
+     *
+     * Return number of elements in the set
+     *
+     */
+    size_t cardinality() const;
+
+    // Return number of runs of consecutive ints
+    size_t runs() const;
+
+    // Transform the IntervalSet into an empty set
+    void make_empty();
+
+    /** Return the values stored in the IntervalSet
+     *
+     * Return a sorted vector with all elements of the set
+     *
+     */
+    std::vector<int> to_vector() const;
+
+    // Return a Set (sorted doubly linked list) with all elements of the set
+    Set to_set() const;
+
+    /** Modify IntervalSet *this such that it becomes the union of *this with IntervalSet S
+     *
+     * IntervalSet *this is modified and then returned
+     *
+     */
+    IntervalSet& operator+=(const IntervalSet& S);
+
+    /** Modify IntervalSet *this such that it becomes the intersection of *this with IntervalSet S
+     *
+     * IntervalSet *this is modified and then returned
+     *
+     */
+    IntervalSet& operator*=(const IntervalSet& S);
+
+    /** Modify IntervalSet *this such that it becomes the Set difference between IntervalSet *this and IntervalSet S
+     *
+     * IntervalSet *this is modified and then returned
+     *
+     */
+    IntervalSet& operator-=(const IntervalSet& S);
+
+    /** Return number of nodes a Set with the same values would have
+     *
+     * Every existing IntervalSet counts as two dummy nodes plus one node per int, as Set does,
+     * so that the leak tests written for Set also hold for IntervalSet
+     * 64-bit, as a single IntervalSet may hold more than INT_MAX ints
+     * Used for debug purposes
+     */
+    static std::int64_t get_count_nodes();
+
+private:
+    // Run of the consecutive ints lo, lo + 1, ..., hi
+    struct Run {
+        int lo;
+        int hi;
+
+        bool operator==(const Run& r) const {
+            return lo == r.lo && hi == r.hi;
+        }
+    };
+
+    std::vector<Run> intervals;  // sorted, neither overlapping nor adjacent
+    std::uint64_t counter{0};    // number of ints in the runs
+
+    static std::int64_t count_nodes;  // total number of "nodes" of the existing IntervalSets
+
+    /** Append run [lo, hi] to sorted runs R holding n ints
+     *
+     * The run is merged with the last run of R if they overlap or are adjacent, n is updated
+     * lo must not be smaller than the lo of the last run of R
+     *
+     */
+    static void _append(std::vector<Run>& R, std::uint64_t& n, std::int64_t lo, std::int64_t hi);
+
+    // Replace the runs with R, holding n ints, and update count_nodes
+    void _assign(std::vector<Run>&& R, std::uint64_t n);
+
+    /* **************************** *
+     * Overloaded operators         *
+     * ***************************** */
+
+    // Overloaded operator<<, same format as for Set
+    friend std::ostream& operator<<(std::ostream& os, const IntervalSet& b);
+
+    // Test whether IntervalSet S1 is a subset of IntervalSet S2
+    friend bool operator<=(const IntervalSet& S1, const IntervalSet& S2);
+
+    // Test whether IntervalSet S1 and S2 represent the same set
+    friend bool operator==(const IntervalSet& S1, const IntervalSet& S2);
+
+    // Test whether IntervalSet S1 and S2 represent different sets
+    friend bool operator!=(const IntervalSet& S1, const IntervalSet& S2);
+
+    // Test whether IntervalSet S1 is a strict subset of IntervalSet S2
+    friend bool operator<(const IntervalSet& S1, const IntervalSet& S2);
+
+    /** Overloaded operator+: Set union S1+S2
+     *
+     * S1 is copied, or moved if it is a temporary, and S2 is merged into it
+     *
+     */
+    friend IntervalSet operator+(IntervalSet S1, const IntervalSet& S2) {
+        S1 += S2;
+        return S1;
+    }
+
+    /** Overloaded operator*: Set intersection S1*S2
+     *
+     * S1 is copied, or moved if it is a temporary, and the ints not in S2 are removed
+     *
+     */
+    friend IntervalSet operator*(IntervalSet S1, const IntervalSet& S2) {
+        S1 *= S2;
+        return S1;
+    }
+
+    /** Overloaded operator-: Set difference S1-S2
+     *
+     * S1 is copied, or moved if it is a temporary
+     *
+     */
+    friend IntervalSet operator-(IntervalSet S1, const IntervalSet& S2) {
+        S1 -= S2;
+        return S1;
+    }
+};
@@ -1,9 +1,127 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <string>
 #include <cassert>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <thread>
 
 #include "set.h"
+#include "set_storage.h"
+#include "simd_set.h"
+
+// Set with static storage duration, destroyed after main returns (see the end of main)
+// The std::optional is constructed before main, i.e. before any Node is allocated
+std::optional<Set> static_set;
+
+/** Test phases 0 to 9 for a set type S with the interface of Set
+ *
+ * Used to test that all storage policies behave as Set, including the node count
+ */
+template <typename S>
+void test_set_interface() {
+    {
+        S S1{};
+        S S2{-4};
+        assert(S::get_count_nodes() == 5);
+
+        std::ostringstream os{};
+        os << S1 << " " << S2;
+        assert((os.str() == std::string{"Set is empty! { -4 }"}));
+    }
+    assert(S::get_count_nodes() == 0);
+
+    {
+        std::vector<int> A1{1, 3, 5};
+        std::vector<int> A2{2, 3, 4};
+        std::vector<int> A3{3, 10};
+
+        S S1{A1};
+        S S2{A2};
+        S S3{A3};
+        assert(S::get_count_nodes() == 5 + 5 + 4);
+
+        S3 = S1;
+        assert(S3 == S1 && S::get_count_nodes() == 5 + 5 + 5);
+        assert(S1.is_member(3) && !S1.is_member(4) && !S1.is_member(0) && !S1.is_member(6));
+
+        // mixed-mode arithmetic
+        S3 = 4 - S1 - 5 - (S1 + S2) - 99999;
+        assert(S3 == S{} && S3.cardinality() == 0);
+
+        std::vector<int> A4{3, 4, 24};
+        assert((S2 - 2 + S3 + 24) == S{A4});
+        assert(S::get_count_nodes() == 5 + 5 + 2);
+
+        S2 += 6;
+        A2.push_back(6);
+        assert(S::get_count_nodes() == 5 + 6 + 2);
+        assert(S2 == S{A2});
+
+        // subsets
+        std::vector<int> A5{3, 5};
+        assert(S{A5} <= S1 && S{A5} < S1 && !(S1 < S1) && S1 <= S1);
+        assert(!(S1 <= S{A5}) && S1 != S{A5});
+        assert(S{10} == 10 && 10 == S{10});
+
+        S1 *= S2;
+        assert(S1 == 3);
+        S2 -= S2;
+        assert(S2.is_empty());
+        S1.make_empty();
+        assert(S1.is_empty() && S::get_count_nodes() == 6);
+    }
+    assert(S::get_count_nodes() == 0);
+}
+
+/** Return a sorted vector of at most n distinct random ints in [-range / 2, range - range / 2)
+ *
+ * Used to create random sets
+ */
+std::vector<int> random_sorted(std::mt19937& gen, int n, int range) {
+    std::vector<int> v;
+    for (int i = 0; i < n; ++i) {
+        v.push_back(static_cast<int>(gen() % range) - range / 2);
+    }
+    std::sort(v.begin(), v.end());
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    return v;
+}
+
+/** Return the results of all set operations between S1 and S2, in both orders
+ *
+ * The sets are printed with operator<<, in the same format for all set types
+ */
+template <typename S>
+std::string set_results(const S& S1, const S& S2) {
+    std::ostringstream os{};
+    os << S1 + S2 << S2 + S1 << S1 * S2 << S2 * S1 << S1 - S2 << S2 - S1 << (S1 + S2).cardinality()
+       << (S1 <= S2) << (S2 <= S1) << (S1 * S2 <= S1) << (S1 == S2) << (S1 + S2 == S2) << (S1 < S1 + S2)
+       << (S1 - S2 < S1);
+    return os.str();
+}
+
+/** Test that set types A and B give the same results, for sets with the same ints
+ *
+ * X1 and Y1 (X2 and Y2) must contain the same ints
+ * Both types must also count the same number of nodes, i.e. the other existing sets of types A and B
+ * must contain the same ints
+ */
+template <typename A, typename B>
+void same_results([[maybe_unused]] const A& X1, [[maybe_unused]] const A& X2, [[maybe_unused]] const B& Y1,
+                  [[maybe_unused]] const B& Y2) {
+    assert(set_results(X1, X2) == set_results(Y1, Y2));
+    assert(A::get_count_nodes() == B::get_count_nodes());
+}
+
+// Test that set types A and B give the same results, for the sets with the ints of sorted vectors A1 and A2
+template <typename A, typename B>
+void same_results(const std::vector<int>& A1, const std::vector<int>& A2) {
+    same_results(A{A1}, A{A2}, B{A1}, B{A2});
+}
 
 int main() {
     ///*****************************************************
@@ -289,5 +407,531 @@ int main() {
 
     assert(Set::get_count_nodes() == 0);
 
+    /*****************************************************
+     * TEST PHASE 10                                      *
+     * Nodes are allocated from a pool and recycled       *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 10: node pool\n";
+
+    {
+        std::vector<int> A1;
+        std::vector<int> A2;
+        for (int i = 0; i < 10000; ++i) {
+            A1.push_back(2 * i);
+            A2.push_back(3 * i);
+        }
+
+        {
+            Set S1{A1};
+            Set S2{A2};
+            S1 += S2;
+            assert(S1.cardinality() == 10000 + 10000 - 3334);
+            assert(Set::get_count_nodes() == static_cast<int>(S1.cardinality() + S2.cardinality()) + 4);
+        }
+        assert(Set::get_count_nodes() == 0);
+        assert(Set::get_pool_capacity() >= 10000 + 10000 - 3334 + 10000 + 4);
+
+        // the freed Nodes are reused: the pool does not grow after the first round
+        [[maybe_unused]] std::size_t capacity = 0;
+        for (int k = 0; k < 10; ++k) {
+            {
+                Set S1{A1};
+                Set S2{A2};
+                Set S3 = S1 + S2;
+                S3 -= S1 * S2;
+                assert(S3.cardinality() == 10000 + 10000 - 2 * 3334);
+            }
+            assert(k == 0 || Set::get_pool_capacity() == capacity);
+            capacity = Set::get_pool_capacity();
+        }
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 11                                      *
+     * Empty Sets do not allocate Nodes, assignment       *
+     * exchanges the Nodes of two Sets                    *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 11: dummy Nodes inside the Set\n";
+
+    {
+        std::vector<Set> empty_sets(1000);
+        assert(Set::get_count_nodes() == 2000);  // the dummy Nodes are still counted
+        assert(Set::get_pool_nodes() == 0);
+
+        Set S1{};
+        Set S2{S1};
+        S2 = S1 * S2 - S1;
+        assert(Set::get_pool_nodes() == 0);
+
+        // assignment between empty and non-empty Sets
+        std::vector<int> A1{1, 3, 5};
+        Set S3{A1};
+        S1 = S3;
+        assert(S1 == S3 && Set::get_pool_nodes() == 6);
+
+        S1 = S2;
+        assert(S1.is_empty() && Set::get_pool_nodes() == 3);
+
+        S2 = S3 + 7;
+        std::ostringstream os{};
+        os << S1 << " " << S2 << " " << S3;
+        assert((os.str() == std::string{"Set is empty! { 1 3 5 7 } { 1 3 5 }"}));
+
+        S2 = S3;
+        S1 = Set{};
+        assert(S1.is_empty() && S2 == S3 && Set::get_pool_nodes() == 6);
+        assert(Set::get_count_nodes() == 2000 + 6 + 6);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    assert(Set::get_pool_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 12                                      *
+     * Move semantics: temporaries are not copied         *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 12: move constructor and rvalue operators\n";
+
+    {
+        std::vector<int> A1{1, 3, 5};
+        std::vector<int> A2{2, 3, 4};
+        std::vector<int> A3{3, 10};
+
+        Set S1{A1};
+        Set S2{A2};
+        Set S3{A3};
+
+        // move constructor: no Nodes allocated, the source becomes empty
+        [[maybe_unused]] std::size_t before = Set::get_node_allocations();
+        Set S4{std::move(S1)};
+        assert(Set::get_node_allocations() == before);
+        assert(S1.is_empty() && S4 == Set{A1});
+        S1 = std::move(S4);
+        assert(S4.is_empty() && S1 == Set{A1});
+
+        // a copy of S1 is the only Set copied, then only new values are inserted
+        std::vector<int> A4{1, 2, 3, 4, 5, 10};
+        before = Set::get_node_allocations();
+        Set R = S1 + S2 + S3;
+        assert(Set::get_node_allocations() - before == R.cardinality());
+        assert(R == Set{A4});
+
+        // the temporary right-hand side is reused
+        before = Set::get_node_allocations();
+        R = S1 + (S2 + S3);
+        assert(Set::get_node_allocations() - before == R.cardinality());
+        assert(R == Set{A4});
+
+        // intersection: the copy of S1 is the only allocation
+        before = Set::get_node_allocations();
+        R = S1 * S2 * S3;
+        assert(Set::get_node_allocations() - before == S1.cardinality());
+        assert(R == Set{3});
+
+        before = Set::get_node_allocations();
+        R = S3 * (S1 * S2);
+        assert(Set::get_node_allocations() - before == S1.cardinality());
+        assert(R == Set{3});
+
+        before = Set::get_node_allocations();
+        R = (S1 + S3) * (S2 + S3);
+        assert(Set::get_node_allocations() - before == 4 + 4);
+        assert(R == S3);
+
+        std::vector<int> A5{1, 5};
+        before = Set::get_node_allocations();
+        R = S1 - S2 - S3;
+        assert(Set::get_node_allocations() - before == S1.cardinality());
+        assert(R == Set{A5});
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 13                                      *
+     * Storage policies: Set and FlatSet give the same    *
+     * results                                            *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 13: list and flat storage policies\n";
+
+    test_set_interface<IntSet<ListStorage>>();
+    test_set_interface<IntSet<FlatStorage>>();
+
+    {
+        std::mt19937 gen{13};
+
+        for (int k = 0; k < 200; ++k) {
+            same_results<Set, FlatSet>(random_sorted(gen, static_cast<int>(gen() % 100), 150),
+                                       random_sorted(gen, static_cast<int>(gen() % 100), 150));
+        }
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    assert(FlatSet::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 14                                      *
+     * Vectorized FlatSet kernels, all instruction sets   *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 14: vectorized set kernels\n";
+
+    {
+        std::mt19937 gen{14};
+
+        // random ints, and the smallest and largest ints
+        auto random_values = [&gen](int n, int range) {
+            std::vector<int> v = random_sorted(gen, n, range);
+            v.insert(v.begin(), std::numeric_limits<int>::min());
+            v.push_back(std::numeric_limits<int>::max());
+            return v;
+        };
+
+        for (simd::isa i : {simd::isa::scalar, simd::isa::sse42, simd::isa::avx2}) {
+            simd::set_isa(i);
+
+            for (int k = 0; k < 300; ++k) {
+                // sizes around the block sizes, from sparse to dense overlaps
+                const int range = 10 + static_cast<int>(gen() % 400);
+                same_results<Set, FlatSet>(random_values(static_cast<int>(gen() % 70), range),
+                                           random_values(static_cast<int>(gen() % 70), range));
+            }
+
+            FlatSet F{std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}};
+            F *= F;
+            F += F;
+            assert(F.cardinality() == 10);
+            F -= F;
+            assert(F.is_empty());
+        }
+
+        simd::set_isa(simd::detected_isa());
+    }
+
+    assert(FlatSet::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 15                                      *
+     * Galloping intersection and difference for sets of  *
+     * very different sizes                               *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 15: galloping for skewed sizes\n";
+
+    {
+        std::mt19937 gen{15};
+
+        std::vector<int> big;
+        for (int i = -10000; i < 10000; i += 2) {
+            big.push_back(i);
+        }
+        const Set S_big{big};
+        const FlatSet F_big{big};
+
+        for (int k = 0; k < 200; ++k) {
+            // a few ints, some of them in big, some of them out of its range
+            const std::vector<int> small = random_sorted(gen, static_cast<int>(gen() % 40), 21000);
+
+            const Set S_small{small};
+            const FlatSet F_small{small};
+            same_results(S_small, S_big, F_small, F_big);
+
+            assert((F_big - F_small) + (F_big * F_small) == F_big);
+        }
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    assert(FlatSet::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 16                                      *
+     * Index over Set: is_member and the operations with  *
+     * a small set                                        *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 16: sampled index over Set\n";
+
+    {
+        std::mt19937 gen{16};
+
+        std::vector<int> big;
+        for (int i = -5000; i < 5000; i += 3) {
+            big.push_back(i);
+        }
+        Set S_big{big};
+        FlatSet F_big{big};
+        S_big.build_index();  // copies of S_big are also indexed
+
+        for (int k = 0; k < 200; ++k) {
+            // several ints of small may fall between the same two ints of big
+            const std::vector<int> small = random_sorted(gen, static_cast<int>(gen() % 60), 11000);
+
+            const Set S_small{small};
+            const FlatSet F_small{small};
+            same_results(S_small, S_big, F_small, F_big);
+
+            // modify S_big: the index is updated for every Node inserted or removed
+            if (k % 2 == 0) {
+                S_big += S_small;
+                F_big += F_small;
+            } else {
+                S_big -= S_small;
+                F_big -= F_small;
+            }
+            for (int x = -5600; x < 5600; x += 7) {
+                assert(S_big.is_member(x) == F_big.is_member(x));
+            }
+        }
+        assert(S_big.cardinality() == F_big.cardinality());
+
+        // the const member functions only read the index: an indexed Set can be read by several threads
+        const Set& S_read = S_big;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&S_read, &F_big]() {
+                for (int x = -5600; x < 5600; ++x) {
+                    assert(S_read.is_member(x) == F_big.is_member(x));
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+
+        // the linear merges and make_empty rebuild the index once, at the end
+        S_big *= Set{big};
+        F_big *= FlatSet{big};
+        for (int x = -5600; x < 5600; x += 5) {
+            assert(S_big.is_member(x) == F_big.is_member(x));
+        }
+        S_big.make_empty();
+        S_big += Set{std::vector<int>{1, 2}};
+        assert(S_big.is_member(1) && S_big.is_member(2) && !S_big.is_member(3));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    assert(FlatSet::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 17                                      *
+     * Compressed (Roaring) bitmap representation         *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 17: compressed bitmap storage\n";
+
+    test_set_interface<IntSet<RoaringStorage>>();
+
+    {
+        std::mt19937 gen{17};
+
+        // Mix of sparse ints, ranges and dense blocks, such that all kinds of containers are compared
+        auto random_containers = [&gen]() {
+            std::vector<int> v;
+            const int base = static_cast<int>(gen() % 4) * 65536 - 131072;
+            switch (gen() % 4) {
+                case 0:  // sparse, several containers
+                    for (int i = static_cast<int>(gen() % 3000); i > 0; --i) {
+                        v.push_back(base + static_cast<int>(gen() % 300000));
+                    }
+                    break;
+                case 1:  // a few ranges
+                    for (int r = static_cast<int>(gen() % 5); r > 0; --r) {
+                        const int lo = base + static_cast<int>(gen() % 200000);
+                        for (int x = lo; x < lo + static_cast<int>(gen() % 70000); ++x) {
+                            v.push_back(x);
+                        }
+                    }
+                    break;
+                case 2:  // dense random ints
+                    for (int i = 0; i < 30000; ++i) {
+                        v.push_back(base + static_cast<int>(gen() % 100000));
+                    }
+                    break;
+                default:  // extreme ints
+                    for (int i = 0; i < 100; ++i) {
+                        v.push_back(std::numeric_limits<int>::min() + static_cast<int>(gen() % 1000));
+                        v.push_back(std::numeric_limits<int>::max() - static_cast<int>(gen() % 1000));
+                    }
+                    v.push_back(-1);
+                    v.push_back(0);
+            }
+            std::sort(v.begin(), v.end());
+            v.erase(std::unique(v.begin(), v.end()), v.end());
+            return v;
+        };
+
+        for (int k = 0; k < 100; ++k) {
+            const std::vector<int> A1 = random_containers();
+            const std::vector<int> A2 = random_containers();
+
+            const RoaringSet R1{A1};
+            const RoaringSet R2{A2};
+            const FlatSet F1{A1};
+            const FlatSet F2{A2};
+            assert(R1.to_vector() == A1);
+
+            same_results(R1, R2, F1, F2);
+
+            for (int i = 0; i < 100; ++i) {
+                // an int of A1 and its neighbour, which may or may not be in A1
+                [[maybe_unused]] const int x = A1.empty() ? static_cast<int>(gen() % 1000) : A1[gen() % A1.size()];
+                assert(R1.is_member(x) == F1.is_member(x));
+                assert(R1.is_member(x ^ 1) == F1.is_member(x ^ 1));
+            }
+        }
+    }
+
+    {
+        // conversion from and to Set
+        std::vector<int> A;
+        for (int x = -1000; x < 1000; ++x) {
+            A.push_back(3 * x);
+        }
+        const Set S{A};
+        const RoaringSet R{S};
+        assert(R.cardinality() == S.cardinality() && R.to_set() == S);
+
+        // a range of ints takes a few bytes per 2^16 ints: 1000 times less than a vector
+        std::vector<int> range;
+        for (int x = 0; x < 1000000; ++x) {
+            range.push_back(x);
+        }
+        const RoaringSet R_range{range};
+        assert(R_range.cardinality() == 1000000);
+        assert(R_range.get_bytes() * 1000 < range.size() * sizeof(int));
+        assert(R_range - RoaringSet{500000} + 500000 == R_range);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    assert(RoaringSet::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 18                                      *
+     * Interval (run-length) representation               *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 18: interval storage\n";
+
+    test_set_interface<IntSet<IntervalStorage>>();
+
+    {
+        std::mt19937 gen{18};
+
+        // A few ranges and single ints, such that runs overlap, touch and contain each other
+        auto random_runs = [&gen]() {
+            std::vector<int> v;
+            for (int r = static_cast<int>(gen() % 8); r > 0; --r) {
+                const int lo = static_cast<int>(gen() % 400) - 200;
+                for (int x = lo; x < lo + static_cast<int>(gen() % 40); ++x) {
+                    v.push_back(x);
+                }
+            }
+            for (int i = static_cast<int>(gen() % 10); i > 0; --i) {
+                v.push_back(static_cast<int>(gen() % 400) - 200);
+            }
+            std::sort(v.begin(), v.end());
+            v.erase(std::unique(v.begin(), v.end()), v.end());
+            return v;
+        };
+
+        for (int k = 0; k < 500; ++k) {
+            const std::vector<int> A1 = random_runs();
+            const std::vector<int> A2 = random_runs();
+
+            const IntervalSet I1{A1};
+            const IntervalSet I2{A2};
+            const FlatSet F1{A1};
+            const FlatSet F2{A2};
+            assert(I1.to_vector() == A1);
+
+            same_results(I1, I2, F1, F2);
+
+            for (int x = -250; x < 250; ++x) {
+                assert(I1.is_member(x) == F1.is_member(x));
+            }
+        }
+    }
+
+    {
+        // conversion from and to Set
+        std::vector<int> A{-7, -6, -5, 0, 2, 3, 4, 10};
+        const Set S{A};
+        const IntervalSet I{S};
+        assert(I.runs() == 4 && I.cardinality() == A.size() && I.to_set() == S);
+
+        // {1..100000} + {200000..250000}: two runs, whatever the number of ints
+        IntervalSet R = IntervalSet{1, 100000} + IntervalSet{200000, 250000};
+        assert(R.runs() == 2 && R.cardinality() == 150001);
+        R -= IntervalSet{50000, 220000};
+        assert(R.runs() == 2 && R.cardinality() == 49999 + 30000);
+        R += IntervalSet{49999, 220000};
+        assert(R.runs() == 1 && R == IntervalSet(1, 250000));
+        assert(IntervalSet(1000, 2000) < R && !(R <= IntervalSet(2, 250000)));
+
+        // all ints: the cardinality does not fit in an int
+        const IntervalSet all{std::numeric_limits<int>::min(), std::numeric_limits<int>::max()};
+        assert(all.cardinality() == (std::size_t{1} << 32));
+        assert((all - R - IntervalSet{0}).cardinality() == (std::size_t{1} << 32) - 250001);
+        assert((all - R).runs() == 2 && (all * R) == R && R < all);
+        assert(all.is_member(std::numeric_limits<int>::min()) && all.is_member(std::numeric_limits<int>::max()));
+        assert(IntervalSet(5, 4).is_empty());
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    assert(IntervalSet::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 19                                      *
+     * Sets used in several threads at the same time      *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 19: Sets in several threads\n";
+
+    {
+        [[maybe_unused]] const std::ptrdiff_t main_nodes = Set::get_pool_nodes();
+
+        std::vector<int> A1;
+        std::vector<int> A2;
+        for (int i = 0; i < 10000; ++i) {
+            A1.push_back(2 * i);
+            A2.push_back(3 * i);
+        }
+
+        // every thread allocates from its own pool, the Nodes of results[t] are freed by the main thread
+        std::vector<Set> results(4);
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < results.size(); ++t) {
+            threads.emplace_back([&A1, &A2, &results, t]() {
+                for (int k = 0; k < 20; ++k) {
+                    Set S1{A1};
+                    Set S2{A2};
+                    results[t] = S1 + S2 - S1 * S2;
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        for ([[maybe_unused]] const Set& S : results) {
+            assert(S.cardinality() == 10000 + 10000 - 2 * 3334);
+        }
+
+        // the pools of the threads that exited are reused, and Nodes freed by the main thread
+        // are given to another thread
+        std::thread{[&results]() {
+            Set S{results[0]};
+            results[1] = S - results[2];
+            assert(results[1].is_empty());
+        }}.join();
+
+        // the main thread frees the Nodes of results[0], results[2] and results[3], allocated by other threads
+        results.clear();
+        assert(Set::get_pool_nodes() == main_nodes - 3 * (10000 + 10000 - 2 * 3334));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    // The Nodes of a Set with static storage duration are freed when the static objects are destroyed,
+    // after main returns: the pool of Nodes must still exist then
+    static_set.emplace(std::vector<int>{1, 2, 3});
+    *static_set += Set{4};
+
     std::cout << "Great Success!!\n";
 }
@@ -1,14 +1,19 @@
 #pragma once
 
+#include <atomic>
 #include <cassert>
+#include <cstddef>
 
 #include "set.h"
+#include "node_pool.h"
 
 /** Class Set::Node
  *
  * This class represents an internal node of a doubly linked list storing an int
  * All members of class Set::Node are public
  * but only class Set can access them, since Node is declared in the private part of class Set
+ * Nodes are allocated from a NodePool of the calling thread (class-specific operator new and delete),
+ * such that inserting a Node does not call malloc, nor take a lock, and consecutive Nodes are close in memory
  *
  */
 class Set::Node {
@@ -42,5 +47,21 @@ public:
     Node* next;  // Pointer to the next Node
     Node* prev;  // Pointer to the previous Node
 
-    static int count_nodes;  // total number of existing nodes -- to help to detect bugs in the code
+    static std::atomic<int> count_nodes;  // total number of existing nodes -- to help to detect bugs in the code
+
+    // Allocation of Nodes from the pool of the calling thread
+    static void* operator new([[maybe_unused]] std::size_t size) {
+        assert(size == sizeof(Node));
+        return ThreadPools<sizeof(Node)>::allocate();
+    }
+
+    static void operator delete(void* p) noexcept {
+        ThreadPools<sizeof(Node)>::deallocate(p);
+    }
+
+    // Pool of the calling thread
+    // The pools are never destroyed: Sets with static storage duration may free their Nodes after main returns
+    static NodePool& pool() {
+        return *ThreadPools<sizeof(Node)>::local();
+    }
 };
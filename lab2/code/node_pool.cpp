@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <new>
+
+#include "node_pool.h"
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+// Constructor
+// Slots smaller than a cache line get a power of two size, such that no object straddles two cache lines
+NodePool::NodePool(std::size_t object_size, std::size_t chunk_bytes) {
+    slot_size_ = std::max(object_size, sizeof(FreeSlot));
+    if (slot_size_ <= cache_line) {
+        std::size_t size = alignof(std::max_align_t);
+        while (size < slot_size_) {
+            size *= 2;
+        }
+        slot_size_ = size;
+    } else {
+        slot_size_ = (slot_size_ + cache_line - 1) / cache_line * cache_line;
+    }
+    slots_per_chunk_ = std::max<std::size_t>(1, chunk_bytes / slot_size_);
+}
+
+// Destructor
+NodePool::~NodePool() {
+    for (void* chunk : chunks_) {
+        ::operator delete(chunk, std::align_val_t{cache_line});
+    }
+}
+
+// Allocate a new chunk, its slots are handed out by allocate() in address order
+void NodePool::add_chunk() {
+    const std::size_t bytes = slots_per_chunk_ * slot_size_;
+
+    chunks_.reserve(chunks_.size() + 1);  // such that push_back cannot throw after the allocation
+    next_ = static_cast<char*>(::operator new(bytes, std::align_val_t{cache_line}));
+    end_ = next_ + bytes;
+    chunks_.push_back(next_);
+}
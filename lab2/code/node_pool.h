@@ -0,0 +1,189 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/** Class to represent a pool of fixed-size memory slots
+ *
+ * Slots are carved, one after the other, from cache-line aligned chunks, such that
+ * objects allocated one after the other are next to each other in memory
+ * Freed slots are recycled through a free list (last freed, first reused)
+ * Chunks are only returned to the system by the destructor
+ * Note: a NodePool is not thread-safe, see ThreadPools below
+ */
+class NodePool {
+public:
+    static constexpr std::size_t cache_line = 64;
+
+    /** Constructor
+     *
+     * \param object_size size of the objects, in bytes
+     * \param chunk_bytes size of the chunks allocated from the system, in bytes
+     *
+     */
+    explicit NodePool(std::size_t object_size, std::size_t chunk_bytes = 4096);
+
+    // Destructor: return all chunks to the system
+    ~NodePool();
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Return a slot of slot_size() bytes
+    void* allocate() {
+        if (free_ != nullptr) {
+            FreeSlot* slot = free_;
+            free_ = slot->next;
+            ++size_;
+            ++allocations_;
+            return slot;
+        }
+        if (next_ == end_) {
+            add_chunk();
+        }
+        void* slot = next_;
+        next_ += slot_size_;
+        ++size_;
+        ++allocations_;
+        return slot;
+    }
+
+    // Give back a slot returned by allocate()
+    void deallocate(void* p) noexcept {
+        FreeSlot* slot = static_cast<FreeSlot*>(p);
+        slot->next = free_;
+        free_ = slot;
+        --size_;
+    }
+
+    // Return size of a slot, in bytes
+    std::size_t slot_size() const {
+        return slot_size_;
+    }
+
+    /** Return number of slots allocated minus number of slots freed with this pool
+     *
+     * The number of slots in use if every slot is freed with the pool it was allocated from,
+     * negative if more slots allocated from other pools were freed with this one
+     *
+     */
+    std::ptrdiff_t size() const {
+        return size_;
+    }
+
+    // Return number of calls to allocate() since the pool was created
+    std::size_t allocations() const {
+        return allocations_;
+    }
+
+    // Return total number of slots in the chunks, used or not
+    std::size_t capacity() const {
+        return chunks_.size() * slots_per_chunk_;
+    }
+
+private:
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    std::size_t slot_size_;
+    std::size_t slots_per_chunk_;
+    std::vector<void*> chunks_;
+
+    FreeSlot* free_{nullptr};  // list of freed slots
+    char* next_{nullptr};      // first slot never used in the last chunk
+    char* end_{nullptr};       // end of the last chunk
+    std::ptrdiff_t size_{0};   // number of slots allocated minus number of slots freed, see size()
+    std::size_t allocations_{0};
+
+    void add_chunk();
+};
+
+/** Pools of fixed-size memory slots, one per thread
+ *
+ * Every thread allocates from, and frees to, its own NodePool without any lock
+ * A slot freed by another thread than the one that allocated it goes to the pool of the freeing thread:
+ * this is safe since the pools are never destroyed, so their chunks are never returned to the system
+ * The size() of a pool is then the balance of the slots allocated and freed by its thread, which may be
+ * negative, the sum over all pools is the number of slots in use
+ * When a thread exits, its pool is kept in a list of idle pools and given to the next thread that needs one,
+ * such that the memory is bounded by the largest number of threads alive at the same time
+ * Slots freed during the exit of a thread, after its pool was given back, go to a shared pool with a lock
+ */
+template <std::size_t ObjectSize>
+class ThreadPools {
+public:
+    // Return a slot of ObjectSize bytes
+    static void* allocate() {
+        if (NodePool* pool = local()) {
+            return pool->allocate();
+        }
+        Shared& s = shared();
+        std::lock_guard<std::mutex> lock{s.mutex};
+        return s.exiting.allocate();
+    }
+
+    // Give back a slot returned by allocate(), possibly in another thread
+    static void deallocate(void* p) noexcept {
+        if (NodePool* pool = local()) {
+            pool->deallocate(p);
+            return;
+        }
+        Shared& s = shared();
+        std::lock_guard<std::mutex> lock{s.mutex};
+        s.exiting.deallocate(p);
+    }
+
+    // Return the pool of the calling thread, nullptr if the thread is exiting and gave its pool back
+    static NodePool* local() {
+        thread_local State state;  // trivially destructible: usable until the thread ends
+
+        if (state.pool == nullptr && !state.released) {
+            state.pool = acquire();
+            thread_local Releaser releaser{state};  // gives the pool back when the thread exits
+        }
+        return state.pool;
+    }
+
+private:
+    struct State {
+        NodePool* pool;
+        bool released;
+    };
+
+    struct Releaser {
+        State& state;
+
+        ~Releaser() {
+            Shared& s = shared();
+            std::lock_guard<std::mutex> lock{s.mutex};
+            s.idle.push_back(state.pool);
+            state.pool = nullptr;
+            state.released = true;
+        }
+    };
+
+    struct Shared {
+        std::mutex mutex;
+        std::vector<NodePool*> idle;          // pools of the threads that exited
+        NodePool exiting{ObjectSize};         // pool of the threads that are exiting
+    };
+
+    // Never destroyed, as the pools
+    static Shared& shared() {
+        static Shared& s = *new Shared;
+        return s;
+    }
+
+    static NodePool* acquire() {
+        Shared& s = shared();
+        std::lock_guard<std::mutex> lock{s.mutex};
+        if (s.idle.empty()) {
+            return new NodePool{ObjectSize};
+        }
+        NodePool* pool = s.idle.back();
+        s.idle.pop_back();
+        return pool;
+    }
+};
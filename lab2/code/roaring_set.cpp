@@ -0,0 +1,758 @@
+#include <algorithm>
+#include <iterator>
+
+#include "roaring_set.h"
+
+std::int64_t RoaringSet::count_nodes = 0;  // initialize total number of "nodes" to zero
+
+namespace roaring {
+
+    namespace {
+
+        using word = std::uint64_t;
+        using kind = Container::kind;
+
+        constexpr std::size_t bitmap_words = 1024;  // 2^16 bits
+        constexpr std::uint32_t array_max = 4096;   // an array with more ints is larger than a bitmap
+        constexpr std::size_t bitmap_bytes = bitmap_words * sizeof(word);
+
+        // Number of bits set in w
+        int popcount(word w) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(w);
+#else
+            int n = 0;
+            for (; w != 0; w &= w - 1) {
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        // Index of the lowest bit set in w, w != 0
+        int lowest_bit(word w) {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(w);
+#else
+            int n = 0;
+            for (; (w & 1) == 0; w >>= 1) {
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        // Map the ints to unsigned ints in the same order (flip the sign bit), and back
+        std::uint32_t to_unsigned(int val) {
+            return static_cast<std::uint32_t>(static_cast<std::int64_t>(val) + 0x80000000LL);
+        }
+
+        int to_int(std::uint32_t u) {
+            return static_cast<int>(static_cast<std::int64_t>(u) - 0x80000000LL);
+        }
+
+        std::uint16_t high(std::uint32_t u) {
+            return static_cast<std::uint16_t>(u >> 16);
+        }
+
+        std::uint16_t low(std::uint32_t u) {
+            return static_cast<std::uint16_t>(u & 0xFFFFu);
+        }
+
+        /* **************************************** *
+         * Representations of a container           *
+         * **************************************** */
+
+        // Runs as inclusive intervals [lo, hi], 32-bit such that hi + 1 does not overflow
+        struct Interval {
+            std::uint32_t lo;
+            std::uint32_t hi;
+        };
+
+        std::vector<Interval> runs_of(const Container& c) {
+            std::vector<Interval> runs(c.data.size() / 2);
+            for (std::size_t r = 0; r < runs.size(); ++r) {
+                runs[r].lo = c.data[2 * r];
+                runs[r].hi = runs[r].lo + c.data[2 * r + 1];
+            }
+            return runs;
+        }
+
+        void set_runs(Container& c, const std::vector<Interval>& runs) {
+            std::vector<std::uint16_t> data;  // not c.data.clear(): the capacity of an array would be kept
+            data.reserve(2 * runs.size());
+            for (const Interval& r : runs) {
+                data.push_back(static_cast<std::uint16_t>(r.lo));
+                data.push_back(static_cast<std::uint16_t>(r.hi - r.lo));
+            }
+            c.data.swap(data);
+            c.type = kind::run;
+        }
+
+        // Set (or clear) the bits lo .. hi, inclusive
+        void fill(std::vector<word>& bits, std::uint32_t lo, std::uint32_t hi, bool value) {
+            const std::size_t first = lo / 64;
+            const std::size_t last = hi / 64;
+            const word first_mask = ~word{0} << (lo % 64);
+            const word last_mask = ~word{0} >> (63 - hi % 64);
+
+            for (std::size_t k = first; k <= last; ++k) {
+                word mask = ~word{0};
+                if (k == first) {
+                    mask &= first_mask;
+                }
+                if (k == last) {
+                    mask &= last_mask;
+                }
+                bits[k] = value ? (bits[k] | mask) : (bits[k] & ~mask);
+            }
+        }
+
+        // Write the ints of c to bitmap bits
+        void to_bitmap(const Container& c, std::vector<word>& bits) {
+            if (c.type == kind::bitmap) {
+                bits = c.bits;
+                return;
+            }
+
+            bits.assign(bitmap_words, 0);
+            if (c.type == kind::array) {
+                for (std::uint16_t x : c.data) {
+                    bits[x / 64] |= word{1} << (x % 64);
+                }
+            } else {
+                for (const Interval& r : runs_of(c)) {
+                    fill(bits, r.lo, r.hi, true);
+                }
+            }
+        }
+
+        // Bitmap with the ints of c, bits is used as storage when c is not a bitmap
+        const std::vector<word>& bitmap_of(const Container& c, std::vector<word>& bits) {
+            if (c.type == kind::bitmap) {
+                return c.bits;
+            }
+            to_bitmap(c, bits);
+            return bits;
+        }
+
+        // Number of runs of consecutive bits set
+        std::uint32_t count_runs(const std::vector<word>& bits) {
+            std::uint32_t n = 0;
+            word carry = 0;  // highest bit of the previous word
+
+            for (word w : bits) {
+                n += static_cast<std::uint32_t>(popcount(w & ~((w << 1) | carry)));  // bits starting a run
+                carry = w >> 63;
+            }
+            return n;
+        }
+
+        std::vector<Interval> runs_from_bitmap(const std::vector<word>& bits) {
+            std::vector<Interval> runs;
+            std::size_t k = 0;
+            word w = bits[0];
+
+            while (true) {
+                while (w == 0) {
+                    if (++k == bitmap_words) {
+                        return runs;
+                    }
+                    w = bits[k];
+                }
+                const std::uint32_t lo = static_cast<std::uint32_t>(k * 64 + lowest_bit(w));
+
+                w |= w - 1;  // the bits below the run are set, the run ends at the first bit not set
+                while (w == ~word{0}) {
+                    if (++k == bitmap_words) {
+                        runs.push_back({lo, 0xFFFFu});
+                        return runs;
+                    }
+                    w = bits[k];
+                }
+                runs.push_back({lo, static_cast<std::uint32_t>(k * 64 + lowest_bit(~w)) - 1});
+                w &= w + 1;  // clear the run
+            }
+        }
+
+        std::vector<std::uint16_t> array_from_bitmap(const std::vector<word>& bits) {
+            std::vector<std::uint16_t> values;
+            for (std::size_t k = 0; k < bitmap_words; ++k) {
+                for (word w = bits[k]; w != 0; w &= w - 1) {
+                    values.push_back(static_cast<std::uint16_t>(k * 64 + lowest_bit(w)));
+                }
+            }
+            return values;
+        }
+
+        /** Convert c to its smallest representation and update its cardinality
+         *
+         * array: 2 bytes per int, bitmap: 8 KB, run: 4 bytes per run
+         * The choice only depends on the ints of c
+         */
+        void normalize(Container& c) {
+            std::uint32_t n_runs = 0;
+
+            switch (c.type) {
+                case kind::array:
+                    c.card = static_cast<std::uint32_t>(c.data.size());
+                    for (std::size_t i = 0; i < c.data.size(); ++i) {
+                        n_runs += (i == 0 || c.data[i] != c.data[i - 1] + 1);
+                    }
+                    break;
+                case kind::run:
+                    c.card = 0;
+                    n_runs = static_cast<std::uint32_t>(c.data.size() / 2);
+                    for (std::size_t r = 0; r < n_runs; ++r) {
+                        c.card += c.data[2 * r + 1] + 1u;
+                    }
+                    break;
+                case kind::bitmap:
+                    c.card = 0;
+                    for (word w : c.bits) {
+                        c.card += static_cast<std::uint32_t>(popcount(w));
+                    }
+                    n_runs = count_runs(c.bits);
+                    break;
+            }
+
+            kind best = (c.card <= array_max) ? kind::array : kind::bitmap;
+            const std::size_t best_bytes = (c.card <= array_max) ? 2 * std::size_t{c.card} : bitmap_bytes;
+            if (4 * std::size_t{n_runs} < best_bytes) {
+                best = kind::run;
+            }
+
+            if (best == c.type || c.card == 0) {
+                return;
+            }
+
+            if (best == kind::bitmap) {
+                to_bitmap(c, c.bits);
+                std::vector<std::uint16_t>().swap(c.data);
+            } else if (best == kind::run) {
+                std::vector<word> storage;
+                const std::vector<Interval> runs = runs_from_bitmap(bitmap_of(c, storage));
+                set_runs(c, runs);
+                std::vector<word>().swap(c.bits);
+            } else if (c.type == kind::run) {  // run to array
+                std::vector<std::uint16_t> values;
+                for (const Interval& r : runs_of(c)) {
+                    for (std::uint32_t x = r.lo; x <= r.hi; ++x) {
+                        values.push_back(static_cast<std::uint16_t>(x));
+                    }
+                }
+                c.data.swap(values);
+            } else {  // bitmap to array
+                c.data = array_from_bitmap(c.bits);
+                std::vector<word>().swap(c.bits);
+            }
+            c.type = best;
+        }
+
+        /* **************************************** *
+         * Operations on containers with equal keys *
+         * **************************************** */
+
+        bool contains(const Container& c, std::uint16_t x) {
+            switch (c.type) {
+                case kind::array:
+                    return std::binary_search(c.data.begin(), c.data.end(), x);
+                case kind::bitmap:
+                    return (c.bits[x / 64] >> (x % 64)) & 1;
+                default: {
+                    // last run starting at or before x
+                    std::size_t lo = 0;
+                    std::size_t hi = c.data.size() / 2;
+                    while (lo < hi) {
+                        const std::size_t mid = (lo + hi) / 2;
+                        if (c.data[2 * mid] <= x) {
+                            lo = mid + 1;
+                        } else {
+                            hi = mid;
+                        }
+                    }
+                    return lo > 0 && x - c.data[2 * (lo - 1)] <= c.data[2 * (lo - 1) + 1];
+                }
+            }
+        }
+
+        // Container with the ints of array a that are (keep_found) or are not in b
+        Container filter(const Container& a, const Container& b, bool keep_found) {
+            Container r;
+            r.key = a.key;
+            for (std::uint16_t x : a.data) {
+                if (contains(b, x) == keep_found) {
+                    r.data.push_back(x);
+                }
+            }
+            return r;
+        }
+
+        Container unite(const Container& a, const Container& b) {
+            Container r;
+            r.key = a.key;
+
+            if (a.type == kind::array && b.type == kind::array) {
+                std::set_union(a.data.begin(), a.data.end(), b.data.begin(), b.data.end(),
+                               std::back_inserter(r.data));
+            } else if (a.type == kind::run && b.type == kind::run) {
+                const std::vector<Interval> ra = runs_of(a);
+                const std::vector<Interval> rb = runs_of(b);
+                std::vector<Interval> runs;
+                std::merge(ra.begin(), ra.end(), rb.begin(), rb.end(), std::back_inserter(runs),
+                           [](const Interval& x, const Interval& y) { return x.lo < y.lo; });
+
+                std::vector<Interval> merged;
+                for (const Interval& x : runs) {
+                    if (!merged.empty() && x.lo <= merged.back().hi + 1) {  // overlapping or adjacent
+                        merged.back().hi = std::max(merged.back().hi, x.hi);
+                    } else {
+                        merged.push_back(x);
+                    }
+                }
+                set_runs(r, merged);
+            } else {
+                std::vector<word> storage;
+                to_bitmap(a, r.bits);
+                const std::vector<word>& bb = bitmap_of(b, storage);
+                for (std::size_t k = 0; k < bitmap_words; ++k) {
+                    r.bits[k] |= bb[k];
+                }
+                r.type = kind::bitmap;
+            }
+
+            normalize(r);
+            return r;
+        }
+
+        Container intersect(const Container& a, const Container& b) {
+            Container r;
+            r.key = a.key;
+
+            if (a.type == kind::array && b.type == kind::array) {
+                std::set_intersection(a.data.begin(), a.data.end(), b.data.begin(), b.data.end(),
+                                      std::back_inserter(r.data));
+            } else if (a.type == kind::array) {
+                r = filter(a, b, true);
+            } else if (b.type == kind::array) {
+                r = filter(b, a, true);
+            } else if (a.type == kind::run && b.type == kind::run) {
+                const std::vector<Interval> ra = runs_of(a);
+                const std::vector<Interval> rb = runs_of(b);
+                std::vector<Interval> runs;
+                std::size_t i = 0;
+                std::size_t j = 0;
+                while (i < ra.size() && j < rb.size()) {
+                    const std::uint32_t lo = std::max(ra[i].lo, rb[j].lo);
+                    const std::uint32_t hi = std::min(ra[i].hi, rb[j].hi);
+                    if (lo <= hi) {
+                        runs.push_back({lo, hi});
+                    }
+                    // the run ending first cannot overlap any later run of the other container
+                    if (ra[i].hi < rb[j].hi) {
+                        ++i;
+                    } else {
+                        ++j;
+                    }
+                }
+                set_runs(r, runs);
+            } else {
+                std::vector<word> storage;
+                to_bitmap(a, r.bits);
+                const std::vector<word>& bb = bitmap_of(b, storage);
+                for (std::size_t k = 0; k < bitmap_words; ++k) {
+                    r.bits[k] &= bb[k];
+                }
+                r.type = kind::bitmap;
+            }
+
+            normalize(r);
+            return r;
+        }
+
+        Container subtract(const Container& a, const Container& b) {
+            Container r;
+            r.key = a.key;
+
+            if (a.type == kind::array && b.type == kind::array) {
+                std::set_difference(a.data.begin(), a.data.end(), b.data.begin(), b.data.end(),
+                                    std::back_inserter(r.data));
+            } else if (a.type == kind::array) {
+                r = filter(a, b, false);
+            } else if (a.type == kind::run && b.type == kind::run) {
+                const std::vector<Interval> ra = runs_of(a);
+                const std::vector<Interval> rb = runs_of(b);
+                std::vector<Interval> runs;
+                std::size_t j = 0;
+                for (Interval x : ra) {
+                    while (j < rb.size() && rb[j].hi < x.lo) {
+                        ++j;
+                    }
+                    // cut the runs of b overlapping x out of it
+                    std::size_t k = j;
+                    bool left = true;  // part of x left after the runs of b cut so far
+                    while (k < rb.size() && rb[k].lo <= x.hi) {
+                        if (rb[k].lo > x.lo) {
+                            runs.push_back({x.lo, rb[k].lo - 1});
+                        }
+                        if (rb[k].hi >= x.hi) {
+                            left = false;
+                            break;
+                        }
+                        x.lo = rb[k].hi + 1;
+                        ++k;
+                    }
+                    if (left) {
+                        runs.push_back(x);
+                    }
+                }
+                set_runs(r, runs);
+            } else {
+                to_bitmap(a, r.bits);
+                r.type = kind::bitmap;
+                if (b.type == kind::array) {
+                    for (std::uint16_t x : b.data) {
+                        r.bits[x / 64] &= ~(word{1} << (x % 64));
+                    }
+                } else if (b.type == kind::run) {
+                    for (const Interval& x : runs_of(b)) {
+                        fill(r.bits, x.lo, x.hi, false);
+                    }
+                } else {
+                    for (std::size_t k = 0; k < bitmap_words; ++k) {
+                        r.bits[k] &= ~b.bits[k];
+                    }
+                }
+            }
+
+            normalize(r);
+            return r;
+        }
+
+        // Test whether the ints of a are in b
+        bool subset(const Container& a, const Container& b) {
+            if (a.card > b.card) {
+                return false;
+            }
+            if (a.type == kind::array) {
+                return std::all_of(a.data.begin(), a.data.end(), [&b](std::uint16_t x) { return contains(b, x); });
+            }
+
+            std::vector<word> storage_a;
+            std::vector<word> storage_b;
+            const std::vector<word>& ba = bitmap_of(a, storage_a);
+            const std::vector<word>& bb = bitmap_of(b, storage_b);
+            for (std::size_t k = 0; k < bitmap_words; ++k) {
+                if ((ba[k] & ~bb[k]) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Call f(x) for the ints x of c, in increasing order
+        template <typename F>
+        void for_each(const Container& c, F f) {
+            const std::uint32_t base = std::uint32_t{c.key} << 16;
+
+            switch (c.type) {
+                case kind::array:
+                    for (std::uint16_t x : c.data) {
+                        f(base | x);
+                    }
+                    break;
+                case kind::bitmap:
+                    for (std::size_t k = 0; k < bitmap_words; ++k) {
+                        for (word w = c.bits[k]; w != 0; w &= w - 1) {
+                            f(base | static_cast<std::uint32_t>(k * 64 + lowest_bit(w)));
+                        }
+                    }
+                    break;
+                case kind::run:
+                    for (const Interval& r : runs_of(c)) {
+                        for (std::uint32_t x = r.lo; x <= r.hi; ++x) {
+                            f(base | x);
+                        }
+                    }
+                    break;
+            }
+        }
+
+        bool less_key(const Container& c, std::uint16_t key) {
+            return c.key < key;
+        }
+
+    }  // namespace
+
+}  // namespace roaring
+
+using roaring::Container;
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+// Used for debug purposes
+// Return number of "nodes" of the existing RoaringSets  -- static member function
+std::int64_t RoaringSet::get_count_nodes() {
+    return RoaringSet::count_nodes;
+}
+
+// Default constructor
+RoaringSet::RoaringSet() {
+    count_nodes += 2;  // the dummy nodes of a Set
+}
+
+// Conversion constructor
+RoaringSet::RoaringSet(int n) : RoaringSet{std::vector<int>{n}} {
+}
+
+// Constructor to create a RoaringSet from a sorted vector v
+// The ints with the same key are collected in an array, which is then normalized
+RoaringSet::RoaringSet(const std::vector<int>& v) {
+    for (int x : v) {
+        const std::uint32_t u = roaring::to_unsigned(x);
+        if (containers.empty() || containers.back().key != roaring::high(u)) {
+            if (!containers.empty()) {
+                roaring::normalize(containers.back());
+            }
+            containers.emplace_back();
+            containers.back().key = roaring::high(u);
+        }
+        containers.back().data.push_back(roaring::low(u));
+    }
+    if (!containers.empty()) {
+        roaring::normalize(containers.back());
+    }
+
+    count_nodes += 2 + static_cast<std::int64_t>(cardinality());
+}
+
+// Constructor to create a RoaringSet from a Set
+RoaringSet::RoaringSet(const Set& S) : RoaringSet{S.to_vector()} {
+}
+
+// Copy constructor
+RoaringSet::RoaringSet(const RoaringSet& source) : containers{source.containers} {
+    count_nodes += 2 + static_cast<std::int64_t>(cardinality());
+}
+
+// Move constructor
+RoaringSet::RoaringSet(RoaringSet&& source) noexcept {
+    count_nodes += 2;
+    containers.swap(source.containers);
+}
+
+RoaringSet::~RoaringSet() {
+    count_nodes -= 2 + static_cast<std::int64_t>(cardinality());
+}
+
+// Copy-and-swap assignment operator
+// The number of "nodes" of *this and source are exchanged: no change in total
+RoaringSet& RoaringSet::operator=(RoaringSet source) {
+    containers.swap(source.containers);
+    return *this;
+}
+
+// Test set membership: binary search for the container, then lookup in it
+bool RoaringSet::is_member(int val) const {
+    const std::uint32_t u = roaring::to_unsigned(val);
+    const auto it = std::lower_bound(containers.begin(), containers.end(), roaring::high(u), roaring::less_key);
+    return it != containers.end() && it->key == roaring::high(u) && roaring::contains(*it, roaring::low(u));
+}
+
+// Test whether a set is empty
+bool RoaringSet::is_empty() const {
+    return containers.empty();
+}
+
+// Return number of elements in the set, sum of the cardinalities of the containers
+size_t RoaringSet::cardinality() const {
+    std::size_t n = 0;
+    for (const Container& c : containers) {
+        n += c.card;
+    }
+    return n;
+}
+
+// Make the set empty
+void RoaringSet::make_empty() {
+    const std::size_t old_size = cardinality();
+    containers.clear();
+    _resized(old_size);
+}
+
+// Return the values of the set in increasing order
+std::vector<int> RoaringSet::to_vector() const {
+    std::vector<int> v;
+    v.reserve(cardinality());
+    for (const Container& c : containers) {
+        roaring::for_each(c, [&v](std::uint32_t u) { v.push_back(roaring::to_int(u)); });
+    }
+    return v;
+}
+
+// Return the set as a sorted doubly linked list
+Set RoaringSet::to_set() const {
+    return Set{to_vector()};
+}
+
+// Modify *this such that it becomes the union of *this with RoaringSet S
+// The containers with the same key are merged, the other ones are moved (*this) or copied (S)
+RoaringSet& RoaringSet::operator+=(const RoaringSet& S) {
+    if (&S == this) {
+        return *this;
+    }
+
+    const std::size_t old_size = cardinality();
+    std::vector<Container> result;
+    result.reserve(containers.size() + S.containers.size());
+
+    auto i = containers.begin();
+    auto j = S.containers.begin();
+    while (i != containers.end() && j != S.containers.end()) {
+        if (i->key < j->key) {
+            result.push_back(std::move(*i++));
+        } else if (j->key < i->key) {
+            result.push_back(*j++);
+        } else {
+            result.push_back(roaring::unite(*i++, *j++));
+        }
+    }
+    std::move(i, containers.end(), std::back_inserter(result));
+    std::copy(j, S.containers.end(), std::back_inserter(result));
+
+    containers.swap(result);
+    _resized(old_size);
+    return *this;
+}
+
+// Modify *this such that it becomes the intersection of *this with RoaringSet S
+// Only the containers with a key in both sets can be non-empty, they are compacted in place
+RoaringSet& RoaringSet::operator*=(const RoaringSet& S) {
+    if (&S == this) {
+        return *this;
+    }
+
+    const std::size_t old_size = cardinality();
+    std::size_t out = 0;
+
+    auto j = S.containers.begin();
+    for (Container& c : containers) {
+        j = std::lower_bound(j, S.containers.end(), c.key, roaring::less_key);
+        if (j == S.containers.end()) {
+            break;
+        }
+        if (j->key == c.key) {
+            Container r = roaring::intersect(c, *j);
+            if (r.card > 0) {
+                containers[out++] = std::move(r);
+            }
+        }
+    }
+    containers.erase(containers.begin() + static_cast<std::ptrdiff_t>(out), containers.end());
+
+    _resized(old_size);
+    return *this;
+}
+
+// Modify *this such that it becomes the RoaringSet difference between *this and RoaringSet S
+// The containers without a key in S are kept as they are, compacted in place
+RoaringSet& RoaringSet::operator-=(const RoaringSet& S) {
+    if (&S == this) {
+        make_empty();
+        return *this;
+    }
+
+    const std::size_t old_size = cardinality();
+    std::size_t out = 0;
+
+    auto j = S.containers.begin();
+    for (Container& c : containers) {
+        j = std::lower_bound(j, S.containers.end(), c.key, roaring::less_key);
+        if (j != S.containers.end() && j->key == c.key) {
+            Container r = roaring::subtract(c, *j);
+            if (r.card > 0) {
+                containers[out++] = std::move(r);
+            }
+        } else {
+            if (&containers[out] != &c) {
+                containers[out] = std::move(c);
+            }
+            ++out;
+        }
+    }
+    containers.erase(containers.begin() + static_cast<std::ptrdiff_t>(out), containers.end());
+
+    _resized(old_size);
+    return *this;
+}
+
+// Used for debug purposes
+// Return number of bytes used by the containers
+std::size_t RoaringSet::get_bytes() const {
+    std::size_t bytes = sizeof(RoaringSet) + containers.capacity() * sizeof(Container);
+    for (const Container& c : containers) {
+        bytes += c.data.capacity() * sizeof(std::uint16_t) + c.bits.capacity() * sizeof(std::uint64_t);
+    }
+    return bytes;
+}
+
+// Overloaded stream insertion operator<<
+std::ostream& operator<<(std::ostream& os, const RoaringSet& b) {
+    if (b.is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (int x : b.to_vector()) {
+            os << x << " ";
+        }
+        os << "}";
+    }
+    return os;
+}
+
+// Overloaded subset operator<=
+// Every container of S1 must be a subset of the container of S2 with the same key
+bool operator<=(const RoaringSet& S1, const RoaringSet& S2) {
+    if (S1.cardinality() > S2.cardinality()) {
+        return false;
+    }
+
+    auto j = S2.containers.begin();
+    for (const Container& c : S1.containers) {
+        j = std::lower_bound(j, S2.containers.end(), c.key, roaring::less_key);
+        if (j == S2.containers.end() || j->key != c.key || !roaring::subset(c, *j)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Overloaded proper subset operator<
+bool operator<(const RoaringSet& S1, const RoaringSet& S2) {
+    return S1.cardinality() < S2.cardinality() && S1 <= S2;
+}
+
+// Overloaded equality operator==
+// The containers are normalized: equal sets have containers with the same representations
+bool operator==(const RoaringSet& S1, const RoaringSet& S2) {
+    return std::equal(S1.containers.begin(), S1.containers.end(), S2.containers.begin(), S2.containers.end(),
+                      [](const Container& a, const Container& b) {
+                          return a.key == b.key && a.type == b.type && a.data == b.data && a.bits == b.bits;
+                      });
+}
+
+// Overloaded not equal operator!=
+bool operator!=(const RoaringSet& S1, const RoaringSet& S2) {
+    return !(S1 == S2);
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+// Update count_nodes after the number of values changed from old_size
+void RoaringSet::_resized(std::size_t old_size) {
+    count_nodes += static_cast<std::int64_t>(cardinality()) - static_cast<std::int64_t>(old_size);
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "set.h"
+
+namespace roaring {
+
+    // The ints of a RoaringSet with the same 16 high bits (key), in one of three representations
+    struct Container {
+        enum class kind : std::uint8_t { array, bitmap, run };
+
+        std::uint16_t key = 0;
+        kind type = kind::array;
+        std::uint32_t card = 0;           // number of ints, 1 .. 2^16
+        std::vector<std::uint16_t> data;  // array: sorted low halves, run: pairs (start, length - 1)
+        std::vector<std::uint64_t> bits;  // bitmap: 1024 words
+    };
+
+}  // namespace roaring
+
+/** Class to represent a Set of ints, stored as a compressed (Roaring) bitmap
+ *
+ * RoaringSet has the same interface as Set (set.h), but the ints are split on their 16 high bits
+ * into containers of at most 2^16 ints, each stored in the smallest of three representations:
+ * - array: sorted 16-bit low halves, 2 bytes per int (sparse containers)
+ * - bitmap: 2^16 bits, 8 KB whatever the number of ints (dense containers)
+ * - run: sorted runs [start, start + length - 1], 4 bytes per run (ranges of consecutive ints)
+ * A range of ints takes a few bytes instead of a list Node (value, two pointers) per int
+ *
+ * The ints are mapped to unsigned keys by flipping the sign bit, such that the containers
+ * are sorted in the same order as the ints
+ * Every container is converted to its smallest representation after each operation:
+ * the representation only depends on the ints stored, so equal sets have equal containers
+ *
+ * All RoaringSet operations have a linear complexity in the size of the containers, in the worst case
+ * The bitmaps are combined a 64-bit word at a time and their cardinality is counted with popcount
+ * is_member is a binary search over the containers followed by a lookup in one container
+ */
+class RoaringSet {
+public:
+    // Default constructor: create an empty RoaringSet
+    RoaringSet();
+
+    // Conversion constructor: convert val into a singleton {val}
+    RoaringSet(int val);
+
+    /** Constructor to create a RoaringSet from a sorted vector of ints
+     *
+     * Create a RoaringSet with all ints in sorted vector v
+     * \param v sorted vector of ints
+     *
+     */
+    RoaringSet(const std::vector<int>& v);
+
+    /** Constructor to create a RoaringSet from a Set
+     *
+     * Create a RoaringSet with all ints in Set S
+     *
+     */
+    explicit RoaringSet(const Set& S);
+
+    /** Copy constructor
+     *
+     * Create a new RoaringSet as a copy of RoaringSet b
+     * \param b RoaringSet to be copied
+     * Function does not modify RoaringSet b in any way
+     *
+     */
+    RoaringSet(const RoaringSet& b);
+
+    /** Move constructor
+     *
+     * Create a new RoaringSet with the containers of RoaringSet b, which becomes empty
+     *
+     */
+    RoaringSet(RoaringSet&& b) noexcept;
+
+    // Destructor
+    ~RoaringSet();
+
+    /** Assignment operator
+     *
+     * Assigns new contents to the RoaringSet, replacing its current content
+     * \param source RoaringSet to be copied (or moved) into RoaringSet *this
+     *
+     */
+    RoaringSet& operator=(RoaringSet source);
+
+    /** Test whether val belongs to the RoaringSet
+     *
+     * Return true if val belongs to the set, otherwise false
+     *
+     */
+    bool is_member(int val) const;
+
+    /** Test whether the RoaringSet is empty
+     *
+     * Return true if the set is empty, otherwise false
+     *
+     */
+    bool is_empty() const;
+
+    /** Count the number of values stored in the RoaringSet
+     *
+     * Return number of elements in the set
+     * The cardinality of every container is stored, a bitmap is counted with popcount when it changes
+     *
+     */
+    size_t cardinality() const;
+
+    // Transform the RoaringSet into an empty set
+    void make_empty();
+
+    /** Return the values stored in the RoaringSet
+     *
+     * Return a sorted vector with all elements of the set
+     *
+     */
+    std::vector<int> to_vector() const;
+
+    // Return a Set (sorted doubly linked list) with all elements of the set
+    Set to_set() const;
+
+    /** Modify RoaringSet *this such that it becomes the union of *this with RoaringSet S
+     *
+     * RoaringSet *this is modified and then returned
+     *
+     */
+    RoaringSet& operator+=(const RoaringSet& S);
+
+    /** Modify RoaringSet *this such that it becomes the intersection of *this with RoaringSet S
+     *
+     * RoaringSet *this is modified and then returned
+     *
+     */
+    RoaringSet& operator*=(const RoaringSet& S);
+
+    /** Modify RoaringSet *this such that it becomes the Set difference between RoaringSet *this and RoaringSet S
+     *
+     * RoaringSet *this is modified and then returned
+     *
+     */
+    RoaringSet& operator-=(const RoaringSet& S);
+
+    /** Return number of bytes used by the containers
+     *
+     * Used for debug purposes
+     */
+    std::size_t get_bytes() const;
+
+    /** Return number of nodes a Set with the same values would have
+     *
+     * Every existing RoaringSet counts as two dummy nodes plus one node per int, as Set does,
+     * so that the leak tests written for Set also hold for RoaringSet
+     * 64-bit, as a RoaringSet may hold more than INT_MAX ints
+     * Used for debug purposes
+     */
+    static std::int64_t get_count_nodes();
+
+private:
+    std::vector<roaring::Container> containers;  // sorted by key, no empty container
+
+    static std::int64_t count_nodes;  // total number of "nodes" of the existing RoaringSets
+
+    // Update count_nodes after the number of values changed from old_size
+    void _resized(std::size_t old_size);
+
+    /* **************************** *
+     * Overloaded operators         *
+     * ***************************** */
+
+    // Overloaded operator<<, same format as for Set
+    friend std::ostream& operator<<(std::ostream& os, const RoaringSet& b);
+
+    // Test whether RoaringSet S1 is a subset of RoaringSet S2
+    friend bool operator<=(const RoaringSet& S1, const RoaringSet& S2);
+
+    // Test whether RoaringSet S1 and S2 represent the same set
+    friend bool operator==(const RoaringSet& S1, const RoaringSet& S2);
+
+    // Test whether RoaringSet S1 and S2 represent different sets
+    friend bool operator!=(const RoaringSet& S1, const RoaringSet& S2);
+
+    // Test whether RoaringSet S1 is a strict subset of RoaringSet S2
+    friend bool operator<(const RoaringSet& S1, const RoaringSet& S2);
+
+    /** Overloaded operator+: Set union S1+S2
+     *
+     * S1 is copied, or moved if it is a temporary, and S2 is merged into it
+     *
+     */
+    friend RoaringSet operator+(RoaringSet S1, const RoaringSet& S2) {
+        S1 += S2;
+        return S1;
+    }
+
+    /** Overloaded operator*: Set intersection S1*S2
+     *
+     * S1 is copied, or moved if it is a temporary, and the ints not in S2 are removed
+     *
+     */
+    friend RoaringSet operator*(RoaringSet S1, const RoaringSet& S2) {
+        S1 *= S2;
+        return S1;
+    }
+
+    /** Overloaded operator-: Set difference S1-S2
+     *
+     * S1 is copied, or moved if it is a temporary
+     *
+     */
+    friend RoaringSet operator-(RoaringSet S1, const RoaringSet& S2) {
+        S1 -= S2;
+        return S1;
+    }
+};
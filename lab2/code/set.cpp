@@ -1,7 +1,21 @@
 #include "set.h"
 #include "node.h"
 
-int Set::Node::count_nodes = 0;  // initialize total number of existing nodes to zero
+#include <algorithm>
+#include <new>
+
+std::atomic<int> Set::Node::count_nodes{0};  // initialize total number of existing nodes to zero
+
+namespace {
+
+    // The set operations use the index when one Set is at least index_ratio times larger
+    constexpr std::size_t index_ratio = 32;
+
+    bool use_index(std::size_t small, std::size_t large) {
+        return small * index_ratio <= large;
+    }
+
+}  // namespace
 
 /*****************************************************
  * Implementation of the member functions             *
@@ -13,8 +27,30 @@ int Set::get_count_nodes() {
     return Set::Node::count_nodes;
 }
 
+// Used for debug purposes
+// Return number of Nodes the pool of the calling thread can hold  -- static member function
+std::size_t Set::get_pool_capacity() {
+    return Set::Node::pool().capacity();
+}
+
+// Used for debug purposes
+// Return number of Nodes allocated minus freed by the calling thread  -- static member function
+std::ptrdiff_t Set::get_pool_nodes() {
+    return Set::Node::pool().size();
+}
+
+// Used for debug purposes
+// Return number of Nodes allocated from the pool of the calling thread since it was created  -- static member function
+std::size_t Set::get_node_allocations() {
+    return Set::Node::pool().allocations();
+}
+
 // Default constructor
-Set::Set() : counter{ 0 }, head{ new Node }, tail{ new Node } {
+// The dummy Nodes are constructed in the Set object (placement new), so that they are counted in count_nodes
+Set::Set() : head{ ::new (sentinels[0]) Node }, tail{ ::new (sentinels[1]) Node }, counter{ 0 } {
+    static_assert(sizeof(Node) <= node_bytes && alignof(Node) <= alignof(void*),
+                  "the dummy Nodes must fit in Set::sentinels");
+
     head->next = tail;
     tail->prev = head;
 }
@@ -38,10 +74,12 @@ Set::Set(const std::vector<int>& v)
 // Make the set empty
 void Set::make_empty() {
     Node* temp = head;
+    const bool was_indexed = _pause_index();  // no search in the index for every Node removed
 
     while (!is_empty()) {
         _remove(temp->next);
     }
+    _resume_index(was_indexed);
 }
 
 Set::~Set() {
@@ -49,9 +87,9 @@ Set::~Set() {
     if (!is_empty()) {
         make_empty();
     }
-    //Mste man ha head->next = nullptr och tail->next = nullptr?
-    delete head;
-    delete tail;
+    // the dummy Nodes are not allocated: only destroy them
+    head->~Node();
+    tail->~Node();
 }
 
 // Copy constructor
@@ -66,36 +104,37 @@ Set::Set(const Set& source)
         p_new = p_new->next;
         p_source = p_source->next;
     }
+
+    if (source.indexed) {
+        build_index();
+    }
 }
 
+// Move constructor
+// The dummy Nodes of source stay in source, the other Nodes are relinked to the dummy Nodes of *this
+Set::Set(Set&& source) noexcept
+    : Set{}  // create an empty list, no allocation
+{
+    _swap(source);
+}
 
 // Copy-and-swap assignment operator
 Set& Set::operator=(Set source) {
-    //swap: constant if non-array but linear if array
-    std::swap(counter, source.counter);
-    std::swap(head, source.head);
-    std::swap(tail, source.tail);
-
+    _swap(source);
     return *this;
 }
 
+// Build the index over the set
+void Set::build_index() {
+    indexed = true;
+    _build_index();
+}
+
 // Test set membership
+// The index, if any, gives the position of val in O(log n) time
 bool Set::is_member(int val) const {
-    if (is_empty()) {
-        return false;
-    }
-
-    Node* temp = head->next;
-    while (temp->next != tail && temp->value < val) {
-        temp = temp->next;
-    }
-
-    if (temp->value == val) {
-        return true;
-    }
-    else {
-        return false;
-    }
+    Node* p = _find_position(val)->next;
+    return p != tail && p->value == val;
 }
 
 // Test whether a set is empty
@@ -109,10 +148,44 @@ size_t Set::cardinality() const {
     return counter;
 }
 
+// Return the values of the set in increasing order
+std::vector<int> Set::to_vector() const {
+    std::vector<int> v;
+    v.reserve(counter);
+    for (Node* p = head->next; p != tail; p = p->next) {
+        v.push_back(p->value);
+    }
+    return v;
+}
+
 
 // Modify *this such that it becomes the union of *this with Set S
 // Add to *this all elements in Set S (repeated elements are not allowed)
 Set& Set::operator+=(const Set& S) {
+    if (indexed && use_index(S.counter, counter)) {
+        // S is small: position every value of S with the index, before inserting anything
+        std::vector<Node*> positions;
+        positions.reserve(S.counter);
+        for (Node* p = S.head->next; p != S.tail; p = p->next) {
+            positions.push_back(_find_position(p->value));
+        }
+
+        Node* rhs_p = S.head->next;
+        Node* last_pos = nullptr;  // position of the last value inserted
+        Node* last = nullptr;      // Node of the last value inserted
+        for (Node* pos : positions) {
+            // values of S with the same position are inserted one after the other
+            Node* p = (pos == last_pos) ? last : pos;
+            if (p->next == tail || p->next->value != rhs_p->value) {
+                _insert(p, rhs_p->value);
+                last_pos = pos;
+                last = p->next;
+            }
+            rhs_p = rhs_p->next;
+        }
+        return *this;
+    }
+
     Node* lhs_p = head->next;
     Node* rhs_p = S.head->next;
 
@@ -138,6 +211,22 @@ Set& Set::operator+=(const Set& S) {
 
 // Modify *this such that it becomes the intersection of *this with Set S
 Set& Set::operator*=(const Set& S) {
+    if (S.indexed && use_index(counter, S.counter)) {
+        // *this is small: look for every value of *this in S with the index of S
+        const bool was_indexed = _pause_index();
+        Node* lhs_p = head->next;
+        while (lhs_p != tail) {
+            lhs_p = lhs_p->next;
+            if (!S.is_member(lhs_p->prev->value)) {
+                _remove(lhs_p->prev);
+            }
+        }
+        _resume_index(was_indexed);
+        return *this;
+    }
+
+    // linear merge: the index of *this, if any, is rebuilt once at the end
+    const bool was_indexed = _pause_index();
     Node* lhs_p = head->next;
     Node* rhs_p = S.head->next;
 
@@ -158,11 +247,43 @@ Set& Set::operator*=(const Set& S) {
             _remove(lhs_p->prev);
         }
     }
+    _resume_index(was_indexed);
     return *this;
 }
 
 // Modify *this such that it becomes the Set difference between Set *this and Set S
 Set& Set::operator-=(const Set& S) {
+    if (S.indexed && use_index(counter, S.counter)) {
+        // *this is small: look for every value of *this in S with the index of S
+        const bool was_indexed = _pause_index();
+        Node* lhs_p = head->next;
+        while (lhs_p != tail) {
+            lhs_p = lhs_p->next;
+            if (S.is_member(lhs_p->prev->value)) {
+                _remove(lhs_p->prev);
+            }
+        }
+        _resume_index(was_indexed);
+        return *this;
+    }
+
+    if (indexed && use_index(S.counter, counter)) {
+        // S is small: find the Nodes to remove with the index, before removing any of them
+        std::vector<Node*> found;
+        for (Node* p = S.head->next; p != S.tail; p = p->next) {
+            Node* q = _find_position(p->value)->next;
+            if (q != tail && q->value == p->value) {
+                found.push_back(q);
+            }
+        }
+        for (Node* q : found) {
+            _remove(q);
+        }
+        return *this;
+    }
+
+    // linear merge: the index of *this, if any, is rebuilt once at the end
+    const bool was_indexed = _pause_index();
     Node* lhs_p = head->next;
     Node* rhs_p = S.head->next;
 
@@ -179,6 +300,7 @@ Set& Set::operator-=(const Set& S) {
             lhs_p = lhs_p->next;
         }
     }
+    _resume_index(was_indexed);
     return *this;
 }
 
@@ -277,16 +399,128 @@ void Set::_insert(Node* p, int val) {
     Node* newNode = new Node(val, p->next, p);
     p->next = p->next->prev = newNode;
     counter++;
+    if (indexed) {
+        _update_index(newNode, false);
+    }
 }
 
 
+// Exchange the Nodes of *this and S
+// The dummy Nodes belong to the Set objects: the first and last Nodes are relinked to the other dummy Nodes
+void Set::_swap(Set& S) {
+    Node* first = head->next;
+    Node* last = tail->prev;
+    Node* S_first = S.head->next;
+    Node* S_last = S.tail->prev;
+
+    if (S.is_empty()) {
+        head->next = tail;
+        tail->prev = head;
+    } else {
+        head->next = S_first;
+        S_first->prev = head;
+        tail->prev = S_last;
+        S_last->next = tail;
+    }
+
+    if (is_empty()) {
+        S.head->next = S.tail;
+        S.tail->prev = S.head;
+    } else {
+        S.head->next = first;
+        first->prev = S.head;
+        S.tail->prev = last;
+        last->next = S.tail;
+    }
+
+    std::swap(counter, S.counter);
+    index.swap(S.index);
+    std::swap(indexed, S.indexed);
+    std::swap(index_changes, S.index_changes);
+}
+
 // Remove the Node pointed by p
 void Set::_remove(Node* p) {
     p->prev->next = p->next;
     p->next->prev = p->prev;
+    if (indexed) {
+        _update_index(p, true);
+    }
     p->prev = p->next = nullptr;
     delete p;
     counter--;
 }
 
+// Return a pointer to the last Node storing a value smaller than val
+// Binary search in the index, then at most index_step Nodes are visited
+Set::Node* Set::_find_position(int val) const {
+    Node* p = head;
+
+    if (!index.empty()) {
+        // first indexed Node with a value >= val, the Node before it in the index is a valid start
+        auto it = std::lower_bound(index.begin(), index.end(), val,
+                                   [](const Node* q, int v) { return q->value < v; });
+        if (it != index.begin()) {
+            p = *(it - 1);
+        }
+    }
+
+    while (p->next != tail && p->next->value < val) {
+        p = p->next;
+    }
+    return p;
+}
+
+// Rebuild the index: every index_step-th Node of the list
+void Set::_build_index() {
+    index.clear();
+    std::size_t i = 0;
+    for (Node* p = head->next; p != tail; p = p->next) {
+        if (++i % index_step == 0) {
+            index.push_back(p);
+        }
+    }
+    index_changes = 0;
+}
 
+// Stop maintaining the index during a bulk removal, return whether the Set was indexed
+// The Nodes are then removed in O(1) time each, instead of a search in the index per Node
+bool Set::_pause_index() {
+    const bool was_indexed = indexed;
+    indexed = false;
+    index.clear();
+    return was_indexed;
+}
+
+// Resume maintaining the index after a bulk removal: rebuilt once, in linear time
+void Set::_resume_index(bool was_indexed) {
+    if (was_indexed) {
+        build_index();
+    }
+}
+
+// Update the index after Node p was inserted or unlinked from the list (p->prev and p->next are still set)
+// An inserted Node is not indexed: the walk from the indexed Node before it is one Node longer
+// A removed indexed Node is replaced by a neighbour which is not indexed yet, if there is one
+// The index is rebuilt after counter / 2 changes: O(1) amortized time per change
+void Set::_update_index(Node* p, bool removed) {
+    if (removed && !index.empty()) {
+        auto it = std::lower_bound(index.begin(), index.end(), p->value,
+                                   [](const Node* q, int v) { return q->value < v; });
+        if (it != index.end() && *it == p) {
+            const bool prev_free = p->prev != head && (it == index.begin() || *(it - 1) != p->prev);
+            const bool next_free = p->next != tail && (it + 1 == index.end() || *(it + 1) != p->next);
+            if (prev_free) {
+                *it = p->prev;
+            } else if (next_free) {
+                *it = p->next;
+            } else {
+                index.erase(it);
+            }
+        }
+    }
+
+    if (2 * ++index_changes > counter + index_step) {
+        _build_index();
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <iostream>
+#include <utility>
 #include <vector>
 
 
@@ -11,6 +13,14 @@
  * two ints with the same value cannot belong to a Set
  *
  * All Set operations must have a linear complexity, in the worst case
+ * The dummy head and tail Nodes are stored inside the Set object, such that
+ * an empty Set does not allocate any memory
+ *
+ * A sparse index of every index_step-th Node can be built on demand (build_index), such that
+ * is_member takes O(log n) time and the set operations between a small and a large indexed Set
+ * only visit the Nodes of the small one, plus O(log n) per int to position it in the large one
+ * The index is maintained by the member functions modifying the Set, the const member functions
+ * only read it
  */
 class Set {
 
@@ -42,6 +52,14 @@ public:
     // IMPLEMENT Lab1 HA
     Set(const Set& b);
 
+    /** Move constructor
+     *
+     * Create a new Set with the Nodes of Set b, which becomes empty
+     * No Nodes are allocated
+     *
+     */
+    Set(Set&& b) noexcept;
+
     /** Destructor
      *
      * Deallocate all memory (Nodes) allocated by the constructor
@@ -54,7 +72,8 @@ public:
      *
      * Assigns new contents to the Set, replacing its current content
      * \param source Set to be copied into Set *this
-     * Call by valued is used.
+     * Call by valued is used: source is move-constructed from an rvalue,
+     * so that assigning a temporary Set does not copy any Node
      *
      */
     // IMPLEMENT Lab1 HA
@@ -82,6 +101,28 @@ public:
      */
     size_t cardinality() const;
 
+    /** Build a sparse index over the Set
+     *
+     * Opt-in: the index takes one pointer per index_step Nodes
+     * Afterwards is_member is O(log n), and so are the searches of the ints of a Set
+     * at least 32 times smaller in +=, *= and -=
+     * Inserting and removing Nodes keep the index up to date, it is rebuilt
+     * when half as many Nodes as the Set holds were inserted or removed since it was built
+     * make_empty and the merges of *= and -= do not update it per Node removed, but rebuild it
+     * once at the end, so that they stay linear
+     * A copy of an indexed Set is also indexed
+     *
+     */
+    void build_index();
+
+    /** Return the values stored in the Set
+     *
+     * Return a sorted vector with all elements of the set
+     * Used to convert a Set to the other set representations
+     *
+     */
+    std::vector<int> to_vector() const;
+
     /** Transform the Set into an empty se
      *
      * Remove all nodes from the list, except the dummy nodes
@@ -120,13 +161,45 @@ public:
      */
     static int get_count_nodes();
 
+    /** Return number of Nodes the pool of the calling thread can hold without allocating memory
+     *
+     * Used for debug purposes
+     */
+    static std::size_t get_pool_capacity();
+
+    /** Return number of Nodes allocated minus number of Nodes freed by the calling thread
+     *
+     * The dummy Nodes are not counted
+     * A Node freed by another thread is given back to the pool of that thread: the result is the number
+     * of Nodes in use only if every Node is freed by the thread that allocated it, it is negative for
+     * a thread that freed more Nodes of other threads than it allocated
+     * Used for debug purposes
+     */
+    static std::ptrdiff_t get_pool_nodes();
+
+    /** Return total number of Nodes allocated from the pool of the calling thread since it was created
+     *
+     * Used for debug purposes
+     */
+    static std::size_t get_node_allocations();
+
 private:
     class Node;  // nested class defined in node.h
 
-    Node* head;      // Pointer to the dummy header Node
-    Node* tail;      // Pointer to the dummy tail Node
+    // Storage for the dummy Nodes, Node is incomplete here: its size is checked in set.cpp
+    static constexpr std::size_t node_bytes = 3 * sizeof(void*);
+    alignas(void*) unsigned char sentinels[2][node_bytes];
+
+    Node* head;      // Pointer to the dummy header Node, in sentinels[0]
+    Node* tail;      // Pointer to the dummy tail Node, in sentinels[1]
     size_t counter;  // number of values in the Set
 
+    // Sparse index: pointers to Nodes about index_step apart, in increasing order of values
+    static constexpr std::size_t index_step = 16;
+    std::vector<Node*> index;
+    bool indexed{false};            // build_index() was called
+    std::size_t index_changes{0};   // Nodes inserted or removed since the index was built
+
     /* **************************  *
      * Private Member Functions    *
      * **************************  */
@@ -148,6 +221,33 @@ private:
      */
     void _remove(Node* p);
 
+    /** Exchange the Nodes of *this and Set S
+     *
+     * The dummy Nodes stay in place, only the first and last Nodes are relinked
+     *
+     */
+    void _swap(Set& S);
+
+    /** Return a pointer to the last Node storing a value smaller than val
+     *
+     * head, if there is none
+     * O(log n + index_step) if the Set is indexed, otherwise O(n)
+     *
+     */
+    Node* _find_position(int val) const;
+
+    // Rebuild the index: every index_step-th Node
+    void _build_index();
+
+    // Update the index after Node p was inserted (removed is false) or unlinked from the list
+    void _update_index(Node* p, bool removed);
+
+    // Stop maintaining the index before removing many Nodes: return whether the Set was indexed
+    bool _pause_index();
+
+    // Rebuild the index after removing many Nodes, if the Set was indexed
+    void _resume_index(bool was_indexed);
+
     /* **************************** *
      * Overloaded operators       *
      * ***************************** */
@@ -194,29 +294,67 @@ private:
      *
      * S1+S2 is the Set of elements in Set S1 or in Set S2 (without repeated elements)
      * Return a new Set representing the union of S1 with S2, S1+S2
+     * S1 is copied, or moved if it is a temporary, and S2 is merged into it
      *
      */
     friend Set operator+(Set S1, const Set& S2) {
-        return (S1 += S2);
+        S1 += S2;
+        return S1;  // S1 is moved, not copied
+    }
+
+    // Union with a temporary S2: the Nodes of S2 are reused
+    friend Set operator+(const Set& S1, Set&& S2) {
+        S2 += S1;
+        return std::move(S2);
+    }
+
+    // Union of two temporaries: the Nodes of the largest Set are reused
+    friend Set operator+(Set&& S1, Set&& S2) {
+        if (S1.cardinality() < S2.cardinality()) {
+            S2 += S1;
+            return std::move(S2);
+        }
+        S1 += S2;
+        return std::move(S1);
     }
 
     /** Overloaded operator*: Set intersection S1*S2
      *
      * S1*S2 is the Set of elements in both Sets S1 and set S2
      * Return a new Set representing the intersection of S1 with S2, S1*S2
+     * S1 is copied, or moved if it is a temporary, and the Nodes not in S2 are removed
      *
      */
     friend Set operator*(Set S1, const Set& S2) {
-        return (S1 *= S2);
+        S1 *= S2;
+        return S1;  // S1 is moved, not copied
+    }
+
+    // Intersection with a temporary S2: the Nodes of S2 are reused
+    friend Set operator*(const Set& S1, Set&& S2) {
+        S2 *= S1;
+        return std::move(S2);
+    }
+
+    // Intersection of two temporaries: the Nodes of the smallest Set are reused
+    friend Set operator*(Set&& S1, Set&& S2) {
+        if (S2.cardinality() < S1.cardinality()) {
+            S2 *= S1;
+            return std::move(S2);
+        }
+        S1 *= S2;
+        return std::move(S1);
     }
 
     /** Overloaded operator-: Set difference S1-S2
      *
      * S1-S2 is the Set of elements in Set S1 that do not belong to Set S2
      * Return a new Set representing the set difference S1-S2
+     * S1 is copied, or moved if it is a temporary
      *
      */
     friend Set operator-(Set S1, const Set& S2) {
-        return (S1 -= S2);
+        S1 -= S2;
+        return S1;  // S1 is moved, not copied
     }
 };
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "set.h"
+#include "flat_set.h"
+#include "roaring_set.h"
+#include "interval_set.h"
+
+/** Storage policies for sets of ints
+ *
+ * ListStorage: sorted doubly linked list (Set), inserting or removing next to a known Node is O(1)
+ * FlatStorage: sorted vector (FlatSet), the set operations are sequential passes over arrays
+ * RoaringStorage: compressed bitmap (RoaringSet), a few bytes per range of consecutive ints
+ * IntervalStorage: sorted runs (IntervalSet), the set operations are linear in the number of runs
+ * All of them have the same interface, code written for IntSet<Storage> works with any of them
+ * get_count_nodes() returns an int for Set, as in its original interface, and a std::int64_t for the
+ * other representations, which may hold more than INT_MAX ints: compare it with another count, or
+ * store it in an auto variable
+ */
+struct ListStorage {
+    using set_type = Set;
+};
+
+struct FlatStorage {
+    using set_type = FlatSet;
+};
+
+struct RoaringStorage {
+    using set_type = RoaringSet;
+};
+
+struct IntervalStorage {
+    using set_type = IntervalSet;
+};
+
+template <typename Storage>
+using IntSet = typename Storage::set_type;
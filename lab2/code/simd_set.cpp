@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "simd_set.h"
+
+// The vectorized kernels need the GCC/Clang target attribute and x86 intrinsics
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_SET_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_SET_X86 0
+#endif
+
+namespace simd {
+
+    namespace {
+
+        /* **************************************** *
+         * Instruction set selection                *
+         * **************************************** */
+
+        isa detect() {
+#if SIMD_SET_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return isa::avx2;
+            }
+            if (__builtin_cpu_supports("sse4.2")) {
+                return isa::sse42;
+            }
+#endif
+            return isa::scalar;
+        }
+
+        std::atomic<isa>& selected() {
+            static std::atomic<isa> s{detect()};
+            return s;
+        }
+
+        /* **************************************** *
+         * Scalar kernels                           *
+         * Branchless merges, also used for the     *
+         * tails that do not fill a block           *
+         * **************************************** */
+
+        std::size_t intersection_scalar(const int* a, std::size_t n, const int* b, std::size_t m, int* out) {
+            std::size_t i = 0;
+            std::size_t j = 0;
+            std::size_t k = 0;
+
+            while (i < n && j < m) {
+                const int x = a[i];
+                const int y = b[j];
+                out[k] = x;  // k <= i: in place, no int of a is overwritten before it is read
+                k += (x == y);
+                i += (x <= y);
+                j += (y <= x);
+            }
+            return k;
+        }
+
+        std::size_t difference_scalar(const int* a, std::size_t n, const int* b, std::size_t m, int* out) {
+            std::size_t i = 0;
+            std::size_t j = 0;
+            std::size_t k = 0;
+
+            while (i < n && j < m) {
+                const int x = a[i];
+                const int y = b[j];
+                out[k] = x;
+                k += (x < y);
+                i += (x <= y);
+                j += (y <= x);
+            }
+            while (i < n) {
+                out[k++] = a[i++];
+            }
+            return k;
+        }
+
+        template <bool keep_found>
+        std::size_t kernel_scalar(const int* a, std::size_t n, const int* b, std::size_t m, int* out) {
+            return keep_found ? intersection_scalar(a, n, b, m, out) : difference_scalar(a, n, b, m, out);
+        }
+
+#if SIMD_SET_X86
+
+        /* **************************************** *
+         * Block kernels                            *
+         * found: mask of the ints of the block of  *
+         * a that are in one of the blocks of b     *
+         * compared so far; the block of a is       *
+         * written when no later block of b can     *
+         * contain its ints                         *
+         * The tail is finished by the scalar       *
+         * kernel, from the first block of b        *
+         * compared with the current block of a     *
+         * (all ints of b before it are smaller)    *
+         * **************************************** */
+
+        // compress[m] moves the lanes selected by the 8-bit mask m to the front of an AVX2 register
+        constexpr std::array<std::array<int, 8>, 256> make_compress8() {
+            std::array<std::array<int, 8>, 256> table{};
+
+            for (int m = 0; m < 256; ++m) {
+                int k = 0;
+                for (int lane = 0; lane < 8; ++lane) {
+                    if (m & (1 << lane)) {
+                        table[m][k++] = lane;
+                    }
+                }
+            }
+            return table;
+        }
+
+        // compress4[m] moves the lanes selected by the 4-bit mask m to the front of an SSE register (pshufb)
+        constexpr std::array<std::array<std::uint8_t, 16>, 16> make_compress4() {
+            std::array<std::array<std::uint8_t, 16>, 16> table{};
+
+            for (int m = 0; m < 16; ++m) {
+                int k = 0;
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (m & (1 << lane)) {
+                        for (int byte = 0; byte < 4; ++byte) {
+                            table[m][4 * k + byte] = static_cast<std::uint8_t>(4 * lane + byte);
+                        }
+                        ++k;
+                    }
+                }
+            }
+            return table;
+        }
+
+        alignas(32) constexpr std::array<std::array<int, 8>, 256> compress8 = make_compress8();
+        alignas(16) constexpr std::array<std::array<std::uint8_t, 16>, 16> compress4 = make_compress4();
+
+        template <bool keep_found>
+        __attribute__((target("avx2,popcnt"))) std::size_t kernel_avx2(const int* a, std::size_t n, const int* b,
+                                                                        std::size_t m, int* out) {
+            const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+            std::size_t i = 0;
+            std::size_t j = 0;
+            std::size_t j_block = 0;  // first block of b compared with the current block of a
+            std::size_t k = 0;
+            unsigned found = 0;
+
+            while (i + 8 <= n && j + 8 <= m) {
+                const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+                __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+
+                // all-against-all: compare with the 8 rotations of the block of b
+                __m256i eq = _mm256_cmpeq_epi32(va, vb);
+                for (int r = 1; r < 8; ++r) {
+                    vb = _mm256_permutevar8x32_epi32(vb, rotate);
+                    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+                }
+                found |= static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+
+                const int a_max = a[i + 7];
+                const int b_max = b[j + 7];
+
+                if (a_max <= b_max) {  // the block of a is done
+                    const unsigned keep = keep_found ? found : (~found & 0xFFu);
+                    const __m256i packed = _mm256_permutevar8x32_epi32(
+                        va, _mm256_load_si256(reinterpret_cast<const __m256i*>(compress8[keep].data())));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), packed);  // k <= i: in place
+                    k += static_cast<std::size_t>(__builtin_popcount(keep));
+                    i += 8;
+                    found = 0;
+                    j += (a_max == b_max) ? 8 : 0;
+                    j_block = j;
+                } else {
+                    j += 8;
+                }
+            }
+
+            return k + kernel_scalar<keep_found>(a + i, n - i, b + j_block, m - j_block, out + k);
+        }
+
+        template <bool keep_found>
+        __attribute__((target("sse4.2,popcnt"))) std::size_t kernel_sse42(const int* a, std::size_t n, const int* b,
+                                                                           std::size_t m, int* out) {
+            std::size_t i = 0;
+            std::size_t j = 0;
+            std::size_t j_block = 0;  // first block of b compared with the current block of a
+            std::size_t k = 0;
+            unsigned found = 0;
+
+            while (i + 4 <= n && j + 4 <= m) {
+                const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+
+                // all-against-all: compare with the 4 rotations of the block of b
+                const __m128i eq0 = _mm_cmpeq_epi32(va, vb);
+                const __m128i eq1 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+                const __m128i eq2 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+                const __m128i eq3 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+                const __m128i eq = _mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3));
+                found |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(eq)));
+
+                const int a_max = a[i + 3];
+                const int b_max = b[j + 3];
+
+                if (a_max <= b_max) {  // the block of a is done
+                    const unsigned keep = keep_found ? found : (~found & 0xFu);
+                    const __m128i packed = _mm_shuffle_epi8(
+                        va, _mm_load_si128(reinterpret_cast<const __m128i*>(compress4[keep].data())));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), packed);  // k <= i: in place
+                    k += static_cast<std::size_t>(__builtin_popcount(keep));
+                    i += 4;
+                    found = 0;
+                    j += (a_max == b_max) ? 4 : 0;
+                    j_block = j;
+                } else {
+                    j += 4;
+                }
+            }
+
+            return k + kernel_scalar<keep_found>(a + i, n - i, b + j_block, m - j_block, out + k);
+        }
+
+        template <bool keep_found>
+        std::size_t dispatch(const int* a, std::size_t n, const int* b, std::size_t m, int* out) {
+            switch (current_isa()) {
+                case isa::avx2:
+                    return kernel_avx2<keep_found>(a, n, b, m, out);
+                case isa::sse42:
+                    return kernel_sse42<keep_found>(a, n, b, m, out);
+                default:
+                    return kernel_scalar<keep_found>(a, n, b, m, out);
+            }
+        }
+
+#else
+
+        template <bool keep_found>
+        std::size_t dispatch(const int* a, std::size_t n, const int* b, std::size_t m, int* out) {
+            return kernel_scalar<keep_found>(a, n, b, m, out);
+        }
+
+#endif  // SIMD_SET_X86
+
+    }  // namespace
+
+    isa detected_isa() {
+        static const isa best = detect();
+        return best;
+    }
+
+    isa current_isa() {
+        return selected().load(std::memory_order_relaxed);
+    }
+
+    void set_isa(isa i) {
+        selected().store(std::min(i, detected_isa()), std::memory_order_relaxed);
+    }
+
+    std::size_t intersection(const int* a, std::size_t n, const int* b, std::size_t m, int* out) {
+        return dispatch<true>(a, n, b, m, out);
+    }
+
+    std::size_t difference(const int* a, std::size_t n, const int* b, std::size_t m, int* out) {
+        return dispatch<false>(a, n, b, m, out);
+    }
+
+}  // namespace simd
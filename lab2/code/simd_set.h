@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+/** Kernels for the operations on sorted arrays of distinct ints (used by FlatSet)
+ *
+ * Blocks of a and b are compared all-against-all in vector registers (AVX2: 8x8 ints,
+ * SSE4.2: 4x4 ints), the ints of a found in b are collected in a mask and the kept ints
+ * are compressed with a shuffle table; the only branch per block is on which block to advance
+ * The kernel is selected at run time, with a branchless scalar fallback on other CPUs and compilers
+ */
+namespace simd {
+
+    // Instruction sets with a kernel, in increasing order of preference
+    enum class isa { scalar, sse42, avx2 };
+
+    // Return the best instruction set supported by the CPU (and by the compiler)
+    isa detected_isa();
+
+    // Return the instruction set used by the kernels
+    isa current_isa();
+
+    /** Select the instruction set used by the kernels
+     *
+     * Used for testing: requests above detected_isa() are lowered to detected_isa()
+     */
+    void set_isa(isa i);
+
+    /** Intersection of sorted arrays of distinct ints
+     *
+     * Write the ints of a[0..n) that also are in b[0..m) to out, in increasing order
+     * \param out room for n ints, out may be a (in place)
+     * Return number of ints written
+     */
+    std::size_t intersection(const int* a, std::size_t n, const int* b, std::size_t m, int* out);
+
+    /** Difference of sorted arrays of distinct ints
+     *
+     * Write the ints of a[0..n) that are not in b[0..m) to out, in increasing order
+     * \param out room for n ints, out may be a (in place)
+     * Return number of ints written
+     */
+    std::size_t difference(const int* a, std::size_t n, const int* b, std::size_t m, int* out);
+
+}  // namespace simd